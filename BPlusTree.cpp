@@ -0,0 +1,494 @@
+#include <iostream>
+#include <limits>
+#include <climits>
+#include <cstdint>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+// Nodes are sized in whole cache lines so a node visit costs a fixed, small
+// number of line fills instead of one miss per key as in RBTree's Node.
+const int CACHE_LINE = 64;
+const int LEAF_KEYS = 28;  // 4 + 28*4 + 8 (next) -> 128 bytes
+const int INNER_KEYS = 20; // 4 + 20*4 + 21*8 (children) -> 256 bytes
+
+struct BPlusNode {
+    int16_t count; // Number of keys in use
+    bool isLeaf;
+};
+
+// Unused key slots always hold INT_MAX so the SIMD search can compare whole vectors
+struct alignas(CACHE_LINE) BPlusLeaf : BPlusNode {
+    int keys[LEAF_KEYS];
+    BPlusLeaf* next; // Next leaf in key order, for scans
+
+    BPlusLeaf() : next(nullptr) {
+        count = 0;
+        isLeaf = true;
+        for (int i = 0; i < LEAF_KEYS; i++)
+            keys[i] = INT_MAX;
+    }
+};
+
+// keys[i] separates children[i] (keys < keys[i]) from children[i + 1] (keys >= keys[i])
+struct alignas(CACHE_LINE) BPlusInner : BPlusNode {
+    int keys[INNER_KEYS];
+    BPlusNode* children[INNER_KEYS + 1];
+
+    BPlusInner() {
+        count = 0;
+        isLeaf = false;
+        for (int i = 0; i < INNER_KEYS; i++)
+            keys[i] = INT_MAX;
+        for (int i = 0; i <= INNER_KEYS; i++)
+            children[i] = nullptr;
+    }
+};
+
+static_assert(sizeof(BPlusLeaf) == 2 * CACHE_LINE, "leaf should fill two cache lines");
+static_assert(sizeof(BPlusInner) == 4 * CACHE_LINE, "inner node should fill four cache lines");
+static_assert(LEAF_KEYS % 4 == 0 && INNER_KEYS % 4 == 0, "key arrays are scanned four at a time");
+
+// Count how many of the first n keys are < key (or <= key when orEqual is set).
+// Keys are sorted, so this is the lower/upper bound position inside the node.
+template <int CAPACITY>
+int rankInNode(const int* keys, int n, int key, bool orEqual) {
+    int rank = 0;
+#ifdef __SSE2__
+    __m128i needle = _mm_set1_epi32(key);
+    for (int i = 0; i < CAPACITY; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        __m128i hit = orEqual ? _mm_andnot_si128(_mm_cmpgt_epi32(block, needle), _mm_set1_epi32(-1))
+                              : _mm_cmplt_epi32(block, needle);
+        rank += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(hit)));
+    }
+    // INT_MAX padding counts as <= INT_MAX; real keys are sorted, so clamp to n
+    return rank < n ? rank : n;
+#else
+    while (rank < n && (keys[rank] < key || (orEqual && keys[rank] == key)))
+        rank++;
+    return rank;
+#endif
+}
+
+class BPlusTree {
+private:
+    BPlusNode* root;
+    bool verbose; // Print progress and the tree after every add/Delete
+
+    static const int MIN_LEAF_KEYS = LEAF_KEYS / 2;
+    static const int MIN_INNER_KEYS = INNER_KEYS / 2;
+
+    BPlusLeaf* findLeaf(int key) const {
+        BPlusNode* node = root;
+        while (!node->isLeaf) {
+            BPlusInner* inner = static_cast<BPlusInner*>(node);
+            node = inner->children[rankInNode<INNER_KEYS>(inner->keys, inner->count, key, true)];
+        }
+        return static_cast<BPlusLeaf*>(node);
+    }
+
+    BPlusLeaf* leftmostLeaf() const {
+        BPlusNode* node = root;
+        while (!node->isLeaf)
+            node = static_cast<BPlusInner*>(node)->children[0];
+        return static_cast<BPlusLeaf*>(node);
+    }
+
+    // Insert key below node. Returns false on a duplicate. When node splits,
+    // upKey/upNode describe the new right sibling the caller must link in.
+    bool insertInto(BPlusNode* node, int key, int& upKey, BPlusNode*& upNode) {
+        upNode = nullptr;
+
+        if (node->isLeaf) {
+            BPlusLeaf* leaf = static_cast<BPlusLeaf*>(node);
+            int pos = rankInNode<LEAF_KEYS>(leaf->keys, leaf->count, key, false);
+            if (pos < leaf->count && leaf->keys[pos] == key)
+                return false;
+
+            if (leaf->count < LEAF_KEYS) {
+                for (int i = leaf->count; i > pos; i--)
+                    leaf->keys[i] = leaf->keys[i - 1];
+                leaf->keys[pos] = key;
+                leaf->count++;
+                return true;
+            }
+
+            // Split a full leaf: left keeps the lower half, right gets the rest
+            int merged[LEAF_KEYS + 1];
+            for (int i = 0, j = 0; i <= LEAF_KEYS; i++)
+                merged[i] = (i == pos) ? key : leaf->keys[j++];
+
+            BPlusLeaf* right = new BPlusLeaf();
+            int leftCount = (LEAF_KEYS + 1) / 2;
+            for (int i = 0; i < LEAF_KEYS; i++)
+                leaf->keys[i] = (i < leftCount) ? merged[i] : INT_MAX;
+            for (int i = leftCount; i <= LEAF_KEYS; i++)
+                right->keys[i - leftCount] = merged[i];
+            leaf->count = leftCount;
+            right->count = LEAF_KEYS + 1 - leftCount;
+
+            right->next = leaf->next;
+            leaf->next = right;
+
+            upKey = right->keys[0];
+            upNode = right;
+            return true;
+        }
+
+        BPlusInner* inner = static_cast<BPlusInner*>(node);
+        int idx = rankInNode<INNER_KEYS>(inner->keys, inner->count, key, true);
+
+        int childKey;
+        BPlusNode* childSplit;
+        if (!insertInto(inner->children[idx], key, childKey, childSplit))
+            return false;
+        if (childSplit == nullptr)
+            return true;
+
+        if (inner->count < INNER_KEYS) {
+            for (int i = inner->count; i > idx; i--) {
+                inner->keys[i] = inner->keys[i - 1];
+                inner->children[i + 1] = inner->children[i];
+            }
+            inner->keys[idx] = childKey;
+            inner->children[idx + 1] = childSplit;
+            inner->count++;
+            return true;
+        }
+
+        // Split a full inner node; the middle key moves up to the parent
+        int mergedKeys[INNER_KEYS + 1];
+        BPlusNode* mergedChildren[INNER_KEYS + 2];
+        for (int i = 0, j = 0; i <= INNER_KEYS; i++)
+            mergedKeys[i] = (i == idx) ? childKey : inner->keys[j++];
+        for (int i = 0, j = 0; i <= INNER_KEYS + 1; i++)
+            mergedChildren[i] = (i == idx + 1) ? childSplit : inner->children[j++];
+
+        BPlusInner* right = new BPlusInner();
+        int leftCount = (INNER_KEYS + 1) / 2;
+        for (int i = 0; i < INNER_KEYS; i++) {
+            inner->keys[i] = (i < leftCount) ? mergedKeys[i] : INT_MAX;
+            inner->children[i + 1] = (i < leftCount) ? mergedChildren[i + 1] : nullptr;
+        }
+        right->count = INNER_KEYS - leftCount;
+        for (int i = 0; i < right->count; i++)
+            right->keys[i] = mergedKeys[leftCount + 1 + i];
+        for (int i = 0; i <= right->count; i++)
+            right->children[i] = mergedChildren[leftCount + 1 + i];
+        inner->count = leftCount;
+
+        upKey = mergedKeys[leftCount];
+        upNode = right;
+        return true;
+    }
+
+    static void removeLeafKey(BPlusLeaf* leaf, int pos) {
+        for (int i = pos; i < leaf->count - 1; i++)
+            leaf->keys[i] = leaf->keys[i + 1];
+        leaf->count--;
+        leaf->keys[leaf->count] = INT_MAX;
+    }
+
+    // Drop keys[pos] and children[pos + 1] from an inner node
+    static void removeInnerEntry(BPlusInner* inner, int pos) {
+        for (int i = pos; i < inner->count - 1; i++) {
+            inner->keys[i] = inner->keys[i + 1];
+            inner->children[i + 1] = inner->children[i + 2];
+        }
+        inner->count--;
+        inner->keys[inner->count] = INT_MAX;
+        inner->children[inner->count + 1] = nullptr;
+    }
+
+    // Fix an underfull leaf at parent->children[idx] by borrowing from or merging with a sibling
+    void rebalanceLeaf(BPlusInner* parent, int idx) {
+        BPlusLeaf* leaf = static_cast<BPlusLeaf*>(parent->children[idx]);
+        BPlusLeaf* left = idx > 0 ? static_cast<BPlusLeaf*>(parent->children[idx - 1]) : nullptr;
+        BPlusLeaf* right = idx < parent->count ? static_cast<BPlusLeaf*>(parent->children[idx + 1]) : nullptr;
+
+        if (left != nullptr && left->count > MIN_LEAF_KEYS) {
+            for (int i = leaf->count; i > 0; i--)
+                leaf->keys[i] = leaf->keys[i - 1];
+            leaf->keys[0] = left->keys[left->count - 1];
+            leaf->count++;
+            removeLeafKey(left, left->count - 1);
+            parent->keys[idx - 1] = leaf->keys[0];
+        } else if (right != nullptr && right->count > MIN_LEAF_KEYS) {
+            leaf->keys[leaf->count++] = right->keys[0];
+            removeLeafKey(right, 0);
+            parent->keys[idx] = right->keys[0];
+        } else if (left != nullptr) {
+            for (int i = 0; i < leaf->count; i++)
+                left->keys[left->count + i] = leaf->keys[i];
+            left->count += leaf->count;
+            left->next = leaf->next;
+            removeInnerEntry(parent, idx - 1);
+            delete leaf;
+        } else {
+            for (int i = 0; i < right->count; i++)
+                leaf->keys[leaf->count + i] = right->keys[i];
+            leaf->count += right->count;
+            leaf->next = right->next;
+            removeInnerEntry(parent, idx);
+            delete right;
+        }
+    }
+
+    // Fix an underfull inner node at parent->children[idx]; separators rotate through the parent
+    void rebalanceInner(BPlusInner* parent, int idx) {
+        BPlusInner* node = static_cast<BPlusInner*>(parent->children[idx]);
+        BPlusInner* left = idx > 0 ? static_cast<BPlusInner*>(parent->children[idx - 1]) : nullptr;
+        BPlusInner* right = idx < parent->count ? static_cast<BPlusInner*>(parent->children[idx + 1]) : nullptr;
+
+        if (left != nullptr && left->count > MIN_INNER_KEYS) {
+            for (int i = node->count; i > 0; i--)
+                node->keys[i] = node->keys[i - 1];
+            for (int i = node->count + 1; i > 0; i--)
+                node->children[i] = node->children[i - 1];
+            node->keys[0] = parent->keys[idx - 1];
+            node->children[0] = left->children[left->count];
+            node->count++;
+
+            parent->keys[idx - 1] = left->keys[left->count - 1];
+            left->children[left->count] = nullptr;
+            left->count--;
+            left->keys[left->count] = INT_MAX;
+        } else if (right != nullptr && right->count > MIN_INNER_KEYS) {
+            node->keys[node->count] = parent->keys[idx];
+            node->children[node->count + 1] = right->children[0];
+            node->count++;
+
+            parent->keys[idx] = right->keys[0];
+            for (int i = 0; i < right->count - 1; i++)
+                right->keys[i] = right->keys[i + 1];
+            for (int i = 0; i < right->count; i++)
+                right->children[i] = right->children[i + 1];
+            right->children[right->count] = nullptr;
+            right->count--;
+            right->keys[right->count] = INT_MAX;
+        } else {
+            // Merge node into its left sibling, or the right sibling into node
+            int sepIdx = (left != nullptr) ? idx - 1 : idx;
+            BPlusInner* dst = (left != nullptr) ? left : node;
+            BPlusInner* src = (left != nullptr) ? node : right;
+
+            dst->keys[dst->count] = parent->keys[sepIdx];
+            for (int i = 0; i < src->count; i++)
+                dst->keys[dst->count + 1 + i] = src->keys[i];
+            for (int i = 0; i <= src->count; i++)
+                dst->children[dst->count + 1 + i] = src->children[i];
+            dst->count += src->count + 1;
+
+            removeInnerEntry(parent, sepIdx);
+            delete src;
+        }
+    }
+
+    bool eraseFrom(BPlusNode* node, int key) {
+        if (node->isLeaf) {
+            BPlusLeaf* leaf = static_cast<BPlusLeaf*>(node);
+            int pos = rankInNode<LEAF_KEYS>(leaf->keys, leaf->count, key, false);
+            if (pos >= leaf->count || leaf->keys[pos] != key)
+                return false;
+            removeLeafKey(leaf, pos);
+            return true;
+        }
+
+        BPlusInner* inner = static_cast<BPlusInner*>(node);
+        int idx = rankInNode<INNER_KEYS>(inner->keys, inner->count, key, true);
+        BPlusNode* child = inner->children[idx];
+        if (!eraseFrom(child, key))
+            return false;
+
+        if (child->isLeaf && child->count < MIN_LEAF_KEYS)
+            rebalanceLeaf(inner, idx);
+        else if (!child->isLeaf && child->count < MIN_INNER_KEYS)
+            rebalanceInner(inner, idx);
+        return true;
+    }
+
+    void destroy(BPlusNode* node) {
+        if (node->isLeaf) {
+            delete static_cast<BPlusLeaf*>(node);
+            return;
+        }
+        BPlusInner* inner = static_cast<BPlusInner*>(node);
+        for (int i = 0; i <= inner->count; i++)
+            destroy(inner->children[i]);
+        delete inner;
+    }
+
+    void displayTree(BPlusNode* node, string indent = "", bool last = true) {
+        cout << indent << (last ? "R----" : "L----") << "[";
+        for (int i = 0; i < node->count; i++) {
+            const int* keys = node->isLeaf ? static_cast<BPlusLeaf*>(node)->keys
+                                           : static_cast<BPlusInner*>(node)->keys;
+            cout << (i ? " " : "") << keys[i];
+        }
+        cout << "]" << (node->isLeaf ? " leaf" : "") << endl;
+
+        if (!node->isLeaf) {
+            BPlusInner* inner = static_cast<BPlusInner*>(node);
+            indent += last ? "   " : "|  ";
+            for (int i = 0; i <= inner->count; i++)
+                displayTree(inner->children[i], indent, i == inner->count);
+        }
+    }
+
+public:
+    BPlusTree(bool verbose = true) : root(new BPlusLeaf()), verbose(verbose) {}
+
+    ~BPlusTree() { destroy(root); }
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    bool find(int key) const {
+        BPlusLeaf* leaf = findLeaf(key);
+        int pos = rankInNode<LEAF_KEYS>(leaf->keys, leaf->count, key, false);
+        return pos < leaf->count && leaf->keys[pos] == key;
+    }
+
+    void add(int key) {
+        if (verbose)
+            cout << "Adding key: " << key << endl;
+
+        int upKey;
+        BPlusNode* upNode;
+        if (!insertInto(root, key, upKey, upNode)) {
+            if (verbose)
+                cout << "Duplicate key detected! Key " << key << " already exists in the tree." << endl;
+            return;
+        }
+
+        if (upNode != nullptr) {
+            BPlusInner* newRoot = new BPlusInner();
+            newRoot->keys[0] = upKey;
+            newRoot->children[0] = root;
+            newRoot->children[1] = upNode;
+            newRoot->count = 1;
+            root = newRoot;
+        }
+
+        if (verbose) {
+            cout << "After insertion:\n";
+            displayTree(root);
+        }
+    }
+
+    void Delete(int key) {
+        if (root->isLeaf && root->count == 0) {
+            if (verbose)
+                cout << "Tree is empty. Nothing to delete." << endl;
+            return;
+        }
+
+        if (!eraseFrom(root, key)) {
+            if (verbose)
+                cout << "Key " << key << " not found." << endl;
+            return;
+        }
+
+        // Shrink the height once the root has a single child left
+        if (!root->isLeaf && root->count == 0) {
+            BPlusInner* oldRoot = static_cast<BPlusInner*>(root);
+            root = oldRoot->children[0];
+            delete oldRoot;
+        }
+
+        if (verbose) {
+            cout << "After deleting " << key << ":\n";
+            displayTree(root);
+        }
+    }
+
+    void inorder() {
+        if (root->isLeaf && root->count == 0) {
+            cout << "Tree is empty. Nothing to traverse." << endl;
+            return;
+        }
+        for (BPlusLeaf* leaf = leftmostLeaf(); leaf != nullptr; leaf = leaf->next)
+            for (int i = 0; i < leaf->count; i++)
+                cout << "Key: " << leaf->keys[i] << endl;
+    }
+
+    // Visit every key in ascending order by walking the leaf chain
+    template <typename Visitor>
+    void inorder(Visitor visit) const {
+        for (BPlusLeaf* leaf = leftmostLeaf(); leaf != nullptr; leaf = leaf->next)
+            for (int i = 0; i < leaf->count; i++)
+                visit(leaf->keys[i]);
+    }
+
+    // Visit keys in [lo, hi] in ascending order
+    template <typename Visitor>
+    void forEachInRange(int lo, int hi, Visitor visit) const {
+        BPlusLeaf* leaf = findLeaf(lo);
+        int pos = rankInNode<LEAF_KEYS>(leaf->keys, leaf->count, lo, false);
+        for (; leaf != nullptr; leaf = leaf->next, pos = 0) {
+            for (int i = pos; i < leaf->count; i++) {
+                if (leaf->keys[i] > hi)
+                    return;
+                visit(leaf->keys[i]);
+            }
+        }
+    }
+};
+
+// Define BPLUSTREE_NO_MAIN to include this file from another program (e.g. a benchmark)
+#ifndef BPLUSTREE_NO_MAIN
+int getValidInput() {
+    int key;
+    while (true) {
+        if (cin >> key)
+            return key;
+        else {
+            cout << "Invalid input! Please enter a valid integer: ";
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+int main() {
+    BPlusTree tree;
+    int choice, key;
+
+    do {
+        cout << "\nB+ Tree Operations Menu\n";
+        cout << "1. Add Key\n";
+        cout << "2. Delete Key\n";
+        cout << "3. Display Inorder Traversal\n";
+        cout << "4. Exit\n";
+        cout << "Enter your choice: ";
+        choice = getValidInput();
+
+        switch (choice) {
+            case 1:
+                cout << "Enter the key to add: ";
+                key = getValidInput();
+                tree.add(key);
+                break;
+            case 2:
+                cout << "Enter the key to delete: ";
+                key = getValidInput();
+                tree.Delete(key);
+                break;
+            case 3:
+                cout << "Displaying Inorder Traversal:\n";
+                tree.inorder();
+                break;
+            case 4:
+                cout << "Exiting...\n";
+                break;
+            default:
+                cout << "Invalid choice! Please try again." << endl;
+        }
+    } while (choice != 4);
+
+    return 0;
+}
+#endif // BPLUSTREE_NO_MAIN
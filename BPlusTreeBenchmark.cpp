@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#define RBT_NO_MAIN
+#include "RBT.cpp"
+#define BPLUSTREE_NO_MAIN
+#include "BPlusTree.cpp"
+
+using namespace std;
+
+// Compares BPlusTree against RBTree on insert, point lookup and full ordered scan.
+// Usage: ./BPlusTreeBenchmark [n1 n2 ...]   (default sizes 1000 10000 100000 1000000)
+
+double elapsedNs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Tree>
+void runWorkload(Tree& tree, const vector<int>& keys, const vector<int>& probes,
+                 double& insertNs, double& lookupNs, double& scanNs, long long& checksum) {
+    auto start = chrono::steady_clock::now();
+    for (int key : keys)
+        tree.add(key);
+    insertNs = elapsedNs(start) / keys.size();
+
+    long long hits = 0;
+    start = chrono::steady_clock::now();
+    for (int key : probes)
+        hits += tree.find(key);
+    lookupNs = elapsedNs(start) / probes.size();
+
+    long long sum = 0;
+    start = chrono::steady_clock::now();
+    tree.inorder([&sum](int key) { sum += key; });
+    scanNs = elapsedNs(start) / keys.size();
+
+    checksum = hits * 31 + sum;
+}
+
+// Random inserts and deletes checked against std::set before any timing is trusted
+bool verifyAgainstSet(int operations) {
+    mt19937 rng(7);
+    uniform_int_distribution<int> keyDist(0, operations / 4);
+    BPlusTree tree(false);
+    set<int> reference;
+
+    for (int i = 0; i < operations; i++) {
+        int key = keyDist(rng);
+        if (rng() % 3 == 0) {
+            tree.Delete(key);
+            reference.erase(key);
+        } else {
+            tree.add(key);
+            reference.insert(key);
+        }
+        if (tree.find(key) != (reference.count(key) == 1))
+            return false;
+    }
+
+    vector<int> scanned;
+    tree.inorder([&scanned](int key) { scanned.push_back(key); });
+    return scanned == vector<int>(reference.begin(), reference.end());
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(atoi(argv[i]));
+    if (sizes.empty())
+        sizes = {1000, 10000, 100000, 1000000};
+
+    if (!verifyAgainstSet(200000)) {
+        cout << "BPlusTree disagrees with std::set, aborting benchmark." << endl;
+        return 1;
+    }
+
+    cout << fixed << setprecision(1);
+    cout << setw(10) << "n" << setw(10) << "tree"
+         << setw(14) << "insert ns/op" << setw(14) << "lookup ns/op" << setw(14) << "scan ns/key" << endl;
+
+    for (int n : sizes) {
+        mt19937 rng(42);
+        vector<int> keys(n);
+        for (int i = 0; i < n; i++)
+            keys[i] = i * 2; // Even keys, so odd probes miss
+        shuffle(keys.begin(), keys.end(), rng);
+
+        vector<int> probes(n);
+        uniform_int_distribution<int> probeDist(0, 2 * n);
+        for (int& probe : probes)
+            probe = probeDist(rng);
+
+        double rbInsert, rbLookup, rbScan, bpInsert, bpLookup, bpScan;
+        long long rbCheck, bpCheck;
+        {
+            RBTree tree(false);
+            runWorkload(tree, keys, probes, rbInsert, rbLookup, rbScan, rbCheck);
+        }
+        {
+            BPlusTree tree(false);
+            runWorkload(tree, keys, probes, bpInsert, bpLookup, bpScan, bpCheck);
+        }
+
+        cout << setw(10) << n << setw(10) << "RBTree"
+             << setw(14) << rbInsert << setw(14) << rbLookup << setw(14) << rbScan << endl;
+        cout << setw(10) << n << setw(10) << "B+Tree"
+             << setw(14) << bpInsert << setw(14) << bpLookup << setw(14) << bpScan << endl;
+        cout << setw(20) << "speedup"
+             << setw(13) << rbInsert / bpInsert << "x" << setw(13) << rbLookup / bpLookup << "x"
+             << setw(13) << rbScan / bpScan << "x" << endl;
+
+        if (rbCheck != bpCheck)
+            cout << "Checksum mismatch at n = " << n << "!" << endl;
+    }
+
+    return 0;
+}
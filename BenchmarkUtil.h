@@ -0,0 +1,123 @@
+#ifndef BENCHMARK_UTIL_H
+#define BENCHMARK_UTIL_H
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Workload helpers shared by the benchmark and load-generator programs. The
+// functions and liveHeapBytes are inline, so the header may be included from
+// several translation units of one program. Define BENCHMARK_HEAP_ACCOUNTING
+// before including it to replace the global operator new/delete with versions
+// that track liveHeapBytes; the replacements cannot be inline, so define it in
+// exactly one translation unit.
+
+// xorshift64*: a fast generator for picking benchmark keys; state must be non-zero
+inline uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+// Zipfian ranks in [0, n), hottest first, with skew theta (Gray et al.,
+// "Quickly Generating Billion-Record Synthetic Databases"), as used by YCSB.
+// theta = 0 gives uniform ranks. resize() follows a population that grows or
+// shrinks in O(|change|) by updating zeta(n) term by term.
+class ZipfGenerator {
+    long long n;
+    double theta, alpha, zetan, zeta2, eta;
+
+    static double zeta(long long n, double theta) {
+        double sum = 0;
+        for (long long i = 1; i <= n; i++)
+            sum += 1.0 / std::pow(double(i), theta);
+        return sum;
+    }
+
+    void updateEta() {
+        eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+public:
+    ZipfGenerator(long long n, double theta = 0.99) : n(n), theta(theta) {
+        zetan = zeta(n, theta);
+        zeta2 = zeta(2, theta);
+        alpha = 1.0 / (1.0 - theta);
+        updateEta();
+    }
+
+    long long size() const { return n; }
+
+    // Change the rank range to [0, newN); newN must be at least 1
+    void resize(long long newN) {
+        for (; n < newN; n++)
+            zetan += 1.0 / std::pow(double(n + 1), theta);
+        for (; n > newN; n--)
+            zetan -= 1.0 / std::pow(double(n), theta);
+        updateEta();
+    }
+
+    long long next(std::mt19937_64& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        if (theta == 0)
+            return (long long)(u * n) % n;
+        double uz = u * zetan;
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + std::pow(0.5, theta))
+            return n > 1 ? 1 : 0;
+        long long rank = (long long)(n * std::pow(eta * u - eta + 1.0, alpha));
+        return rank < n ? rank : n - 1;
+    }
+};
+
+// ---- Heap accounting: live bytes as reported by the allocator ----
+
+inline std::atomic<long long> liveHeapBytes(0);
+
+#if defined(BENCHMARK_HEAP_ACCOUNTING) && defined(__GLIBC__)
+inline void* countedAlloc(size_t size, size_t alignment) {
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t))
+        p = std::malloc(size ? size : 1);
+    else if (posix_memalign(&p, alignment, size ? size : 1) != 0)
+        p = nullptr;
+    if (p == nullptr)
+        throw std::bad_alloc();
+    liveHeapBytes += malloc_usable_size(p);
+    return p;
+}
+
+inline void countedFree(void* p) {
+    if (p == nullptr)
+        return;
+    liveHeapBytes -= malloc_usable_size(p);
+    std::free(p);
+}
+
+void* operator new(size_t size) { return countedAlloc(size, 0); }
+void* operator new[](size_t size) { return countedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t align) { return countedAlloc(size, size_t(align)); }
+void* operator new[](size_t size, std::align_val_t align) { return countedAlloc(size, size_t(align)); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+constexpr bool heapAccounting = true;
+#else
+constexpr bool heapAccounting = false;
+#endif
+
+#endif // BENCHMARK_UTIL_H
@@ -0,0 +1,623 @@
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <set>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+using namespace std;
+
+// Lock-free skip list (Herlihy & Shavit, "The Art of Multiprocessor Programming",
+// ch. 14.4) with the same insert/search/remove interface as SkipList in
+// SkipList.cpp. A node is logically deleted once the low bit of its level-0
+// next pointer is set; marked nodes are snipped out by later traversals and
+// freed through epoch-based reclamation once no thread can still see them.
+
+// Building with -DCONCURRENT_SKIPLIST_YIELD_POINTS makes operations give up
+// the CPU at random points between their steps, so the stress tests reach
+// interleavings that otherwise need many cores to show up.
+#ifdef CONCURRENT_SKIPLIST_YIELD_POINTS
+inline void yieldPoint() {
+    thread_local uint64_t state = 0x9E3779B97F4A7C15ULL ^ hash<thread::id>()(this_thread::get_id());
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    if ((state * 0x2545F4914F6CDD1DULL) >> 62 == 0) // One step in four
+        this_thread::yield();
+}
+#define YIELD_POINT() yieldPoint()
+#else
+#define YIELD_POINT() ((void)0)
+#endif
+
+const int CONCURRENT_MAX_LEVEL = 32;
+const int MAX_THREADS = 128;
+
+struct CNode {
+    int value;
+    int topLevel;
+    atomic<int> handoff;         // INSERT_DONE / REMOVE_DONE / RETIRED bits, see finishNode()
+    atomic<uintptr_t> next[1];   // Marked forward pointers (really topLevel + 1 entries)
+
+    static CNode* create(int value, int topLevel) {
+        size_t bytes = offsetof(CNode, next) + (topLevel + 1) * sizeof(atomic<uintptr_t>);
+        CNode* node = static_cast<CNode*>(operator new(bytes));
+        node->value = value;
+        node->topLevel = topLevel;
+        new (&node->handoff) atomic<int>(0);
+        for (int i = 0; i <= topLevel; i++)
+            new (&node->next[i]) atomic<uintptr_t>(0);
+        return node;
+    }
+
+    static void destroy(CNode* node) { operator delete(node); }
+};
+
+inline CNode* pointerOf(uintptr_t link) { return reinterpret_cast<CNode*>(link & ~uintptr_t(1)); }
+inline bool isMarked(uintptr_t link) { return (link & 1) != 0; }
+inline uintptr_t linkTo(CNode* node, bool marked = false) {
+    return reinterpret_cast<uintptr_t>(node) | (marked ? 1 : 0);
+}
+
+// Small thread ids, reused after a thread exits, index per-thread epoch slots
+class ThreadRegistry {
+    mutex lock;
+    bool used[MAX_THREADS] = {};
+
+public:
+    static ThreadRegistry& instance() {
+        static ThreadRegistry registry;
+        return registry;
+    }
+
+    int acquire() {
+        lock_guard<mutex> guard(lock);
+        for (int i = 0; i < MAX_THREADS; i++) {
+            if (!used[i]) {
+                used[i] = true;
+                return i;
+            }
+        }
+        cerr << "ConcurrentSkipList: more than " << MAX_THREADS << " live threads" << endl;
+        abort();
+    }
+
+    void release(int id) {
+        lock_guard<mutex> guard(lock);
+        used[id] = false;
+    }
+};
+
+struct ThreadId {
+    int id;
+    ThreadId() : id(ThreadRegistry::instance().acquire()) {}
+    ~ThreadId() { ThreadRegistry::instance().release(id); }
+};
+
+inline int currentThreadId() {
+    thread_local ThreadId threadId;
+    return threadId.id;
+}
+
+// Epoch-based reclamation: a retired node is freed once the global epoch has
+// advanced twice, which can only happen after every thread that was inside an
+// operation when it was retired has left that operation.
+class EpochManager {
+    static const size_t RECLAIM_BATCH = 64;
+
+    struct alignas(64) Slot {
+        atomic<uint64_t> epoch{0}; // 0 when idle, otherwise (epoch << 1) | 1
+        vector<pair<uint64_t, CNode*>> retired; // Touched only by the owning thread
+    };
+
+    atomic<uint64_t> globalEpoch{1};
+    Slot slots[MAX_THREADS];
+
+    bool tryAdvance() {
+        uint64_t current = globalEpoch.load();
+        for (int i = 0; i < MAX_THREADS; i++) {
+            uint64_t seen = slots[i].epoch.load();
+            if ((seen & 1) && (seen >> 1) != current)
+                return false;
+        }
+        return globalEpoch.compare_exchange_strong(current, current + 1);
+    }
+
+    void reclaim(Slot& slot) {
+        uint64_t safe = globalEpoch.load();
+        size_t kept = 0;
+        for (size_t i = 0; i < slot.retired.size(); i++) {
+            if (slot.retired[i].first + 2 <= safe)
+                CNode::destroy(slot.retired[i].second);
+            else
+                slot.retired[kept++] = slot.retired[i];
+        }
+        slot.retired.resize(kept);
+    }
+
+public:
+    ~EpochManager() {
+        for (Slot& slot : slots)
+            for (auto& entry : slot.retired)
+                CNode::destroy(entry.second);
+    }
+
+    void enter() { slots[currentThreadId()].epoch.store((globalEpoch.load() << 1) | 1); }
+    void exit() { slots[currentThreadId()].epoch.store(0, memory_order_release); }
+
+    void retire(CNode* node) {
+        Slot& slot = slots[currentThreadId()];
+        slot.retired.emplace_back(globalEpoch.load(), node);
+        if (slot.retired.size() >= RECLAIM_BATCH) {
+            tryAdvance();
+            reclaim(slot);
+        }
+    }
+};
+
+class EpochGuard {
+    EpochManager& epochs;
+
+public:
+    EpochGuard(EpochManager& epochs) : epochs(epochs) { epochs.enter(); }
+    ~EpochGuard() { epochs.exit(); }
+};
+
+class ConcurrentSkipList {
+    static const int INSERT_DONE = 1;
+    static const int REMOVE_DONE = 2;
+    static const int RETIRED = 4;
+
+    CNode* header;
+    atomic<int> level;     // Highest level that may hold nodes; only ever raised
+    atomic<long long> count;
+    EpochManager epochs;
+
+    static int randomLevel() {
+        thread_local uint64_t state = 0x9E3779B97F4A7C15ULL ^ (uint64_t(currentThreadId()) << 32) ^
+                                      uint64_t(chrono::steady_clock::now().time_since_epoch().count());
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        uint64_t bits = (state * 0x2545F4914F6CDD1DULL) | (1ULL << (CONCURRENT_MAX_LEVEL - 1));
+        return __builtin_ctzll(bits);
+    }
+
+    // Fill preds/succs with the neighbours of value on every level, unlinking
+    // any marked nodes met on the way. Returns true if an unmarked node with
+    // value is linked at level 0.
+    bool find(int value, CNode** preds, CNode** succs) {
+    retry:
+        CNode* pred = header;
+        for (int i = level.load(); i >= 0; i--) {
+            YIELD_POINT();
+            CNode* curr = pointerOf(pred->next[i].load());
+            while (curr != nullptr) {
+                YIELD_POINT();
+                uintptr_t succ = curr->next[i].load();
+                while (isMarked(succ)) {
+                    uintptr_t expected = linkTo(curr);
+                    if (!pred->next[i].compare_exchange_strong(expected, linkTo(pointerOf(succ))))
+                        goto retry;
+                    curr = pointerOf(succ);
+                    if (curr == nullptr)
+                        break;
+                    succ = curr->next[i].load();
+                }
+                if (curr == nullptr || curr->value >= value)
+                    break;
+                pred = curr;
+                curr = pointerOf(succ);
+            }
+            preds[i] = pred;
+            succs[i] = curr;
+        }
+        return succs[0] != nullptr && succs[0]->value == value;
+    }
+
+    // One pass over every level that snips victim, which is marked on all of
+    // its levels, by identity. Searching by value is not enough: find() stops
+    // at the first unmarked node >= value, and an insert of the same value may
+    // have linked its node in front of victim on an upper level (it recorded
+    // victim as successor before victim was marked). So each level is walked
+    // through the whole run of equal values, snipping every marked node in it.
+    // Returns true if victim was met, in which case it may have been reachable
+    // until now and the caller has to check again.
+    bool unlinkPass(CNode* victim) {
+        const int value = victim->value;
+    retry:
+        bool met = false;
+        CNode* pred = header; // Last unmarked node < value, where the next level starts
+        for (int i = level.load(); i >= 0; i--) {
+            CNode* runPred = pred;
+            CNode* curr = pointerOf(pred->next[i].load());
+            while (curr != nullptr && curr->value <= value) {
+                YIELD_POINT();
+                uintptr_t succ = curr->next[i].load();
+                if (isMarked(succ)) {
+                    met = met || curr == victim;
+                    uintptr_t expected = linkTo(curr);
+                    if (!runPred->next[i].compare_exchange_strong(expected, linkTo(pointerOf(succ))))
+                        goto retry;
+                } else {
+                    runPred = curr;
+                    if (curr->value < value)
+                        pred = curr;
+                }
+                curr = pointerOf(succ);
+            }
+        }
+        return met;
+    }
+
+    // The inserter may still be linking upper levels while a remover unlinks
+    // the node, so whichever of the two finishes second unlinks it from every
+    // level and retires it. Only a pass that no longer meets the node proves it
+    // unreachable; retiring any earlier lets it be freed while still linked.
+    void finishNode(CNode* node, int doneBit) {
+        int before = node->handoff.fetch_or(doneBit);
+        if ((before | doneBit) != (INSERT_DONE | REMOVE_DONE))
+            return;
+        while (unlinkPass(node)) {
+        }
+        node->handoff.fetch_or(RETIRED);
+        epochs.retire(node);
+    }
+
+public:
+    ConcurrentSkipList() : level(0), count(0) {
+        header = CNode::create(0, CONCURRENT_MAX_LEVEL - 1);
+    }
+
+    ~ConcurrentSkipList() {
+        // No other thread may use the list any more; unlinked nodes are owned by epochs
+        CNode* current = header;
+        while (current != nullptr) {
+            CNode* next = pointerOf(current->next[0].load());
+            CNode::destroy(current);
+            current = next;
+        }
+    }
+
+    ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+    ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+    long long size() const { return count.load(); }
+
+    // Insert a value; returns false if it is already present
+    bool insert(int value) {
+        EpochGuard guard(epochs);
+        CNode* preds[CONCURRENT_MAX_LEVEL];
+        CNode* succs[CONCURRENT_MAX_LEVEL];
+        int topLevel = randomLevel();
+
+        // Publish the new height before any node is linked that high
+        int seen = level.load();
+        while (seen < topLevel && !level.compare_exchange_weak(seen, topLevel)) {
+        }
+
+        CNode* newNode = nullptr;
+        while (true) {
+            if (find(value, preds, succs)) {
+                if (newNode != nullptr)
+                    CNode::destroy(newNode); // Never published
+                return false;
+            }
+            YIELD_POINT();
+            if (newNode == nullptr)
+                newNode = CNode::create(value, topLevel);
+            for (int i = 0; i <= topLevel; i++)
+                newNode->next[i].store(linkTo(succs[i]), memory_order_relaxed);
+
+            // Linking level 0 is the linearization point
+            uintptr_t expected = linkTo(succs[0]);
+            if (preds[0]->next[0].compare_exchange_strong(expected, linkTo(newNode)))
+                break;
+        }
+        count.fetch_add(1);
+
+        for (int i = 1; i <= topLevel; i++) {
+            while (true) {
+                YIELD_POINT();
+                // Point the new node at the current successor, unless a remover marked it
+                uintptr_t own = newNode->next[i].load();
+                if (isMarked(own))
+                    goto done;
+                if (pointerOf(own) != succs[i] && !newNode->next[i].compare_exchange_strong(own, linkTo(succs[i])))
+                    goto done;
+
+                uintptr_t expected = linkTo(succs[i]);
+                if (preds[i]->next[i].compare_exchange_strong(expected, linkTo(newNode)))
+                    break;
+                find(value, preds, succs);
+                if (succs[0] != newNode)
+                    goto done; // Already logically removed
+            }
+        }
+    done:
+        finishNode(newNode, INSERT_DONE);
+        return true;
+    }
+
+    // Wait-free membership test that skips marked nodes without unlinking them
+    bool search(int value) {
+        EpochGuard guard(epochs);
+        CNode* pred = header;
+        CNode* curr = nullptr;
+        for (int i = level.load(); i >= 0; i--) {
+            curr = pointerOf(pred->next[i].load());
+            while (curr != nullptr) {
+                uintptr_t succ = curr->next[i].load();
+                while (isMarked(succ)) {
+                    curr = pointerOf(succ);
+                    if (curr == nullptr)
+                        break;
+                    succ = curr->next[i].load();
+                }
+                if (curr == nullptr || curr->value >= value)
+                    break;
+                pred = curr;
+                curr = pointerOf(succ);
+            }
+        }
+        return curr != nullptr && curr->value == value;
+    }
+
+    // Remove a value; returns false if it was not present
+    bool remove(int value) {
+        EpochGuard guard(epochs);
+        CNode* preds[CONCURRENT_MAX_LEVEL];
+        CNode* succs[CONCURRENT_MAX_LEVEL];
+        if (!find(value, preds, succs))
+            return false;
+
+        CNode* victim = succs[0];
+        for (int i = victim->topLevel; i > 0; i--) {
+            YIELD_POINT();
+            uintptr_t succ = victim->next[i].load();
+            while (!isMarked(succ) && !victim->next[i].compare_exchange_weak(succ, succ | 1)) {
+            }
+        }
+
+        // Marking level 0 is the linearization point; only one remover wins it
+        YIELD_POINT();
+        uintptr_t succ = victim->next[0].load();
+        while (true) {
+            if (isMarked(succ))
+                return false;
+            if (victim->next[0].compare_exchange_strong(succ, succ | 1))
+                break;
+        }
+        count.fetch_sub(1);
+
+        finishNode(victim, REMOVE_DONE);
+        return true;
+    }
+
+    // Structural check for tests, valid only while no other thread is writing:
+    // every level is sorted, every unmarked node on level i > 0 is also on level i - 1,
+    // the unmarked level-0 nodes number size(), and no node handed to the
+    // epoch manager is still linked on any level.
+    bool validate(string* error = nullptr) {
+        EpochGuard guard(epochs);
+        string message;
+        set<CNode*> below;
+        for (int i = 0; i < CONCURRENT_MAX_LEVEL && message.empty(); i++) {
+            set<CNode*> onLevel;
+            long long unmarked = 0;
+            CNode* previous = nullptr;
+            for (CNode* node = pointerOf(header->next[i].load()); node != nullptr;
+                 node = pointerOf(node->next[i].load())) {
+                if (node->handoff.load() & RETIRED) {
+                    message = "retired node " + to_string(node->value) + " is linked on level " + to_string(i);
+                    break;
+                }
+                if (node->topLevel < i) {
+                    message = "node " + to_string(node->value) + " is linked above its height on level " + to_string(i);
+                    break;
+                }
+                if (i > 0 && !isMarked(node->next[0].load()) && below.count(node) == 0) {
+                    message = "node " + to_string(node->value) + " is on level " + to_string(i) + " but not below it";
+                    break;
+                }
+                if (previous != nullptr && previous->value > node->value) {
+                    message = "level " + to_string(i) + " is out of order at " + to_string(node->value);
+                    break;
+                }
+                if (!isMarked(node->next[0].load()))
+                    unmarked++;
+                onLevel.insert(node);
+                previous = node;
+            }
+            if (message.empty() && i == 0 && unmarked != count.load())
+                message = "size() is " + to_string(count.load()) + " but " + to_string(unmarked) + " nodes are present";
+            below.swap(onLevel);
+        }
+        if (error != nullptr)
+            *error = message;
+        return message.empty();
+    }
+
+    // Level-0 contents in order; only meaningful while no other thread is writing
+    vector<int> snapshot() {
+        EpochGuard guard(epochs);
+        vector<int> values;
+        for (CNode* node = pointerOf(header->next[0].load()); node != nullptr;) {
+            uintptr_t next = node->next[0].load();
+            if (!isMarked(next))
+                values.push_back(node->value);
+            node = pointerOf(next);
+        }
+        return values;
+    }
+};
+
+// Define CONCURRENT_SKIPLIST_NO_MAIN to include this file from another program
+#ifndef CONCURRENT_SKIPLIST_NO_MAIN
+#include "BenchmarkUtil.h"
+
+// Every thread owns a disjoint key range, so each return value must match a
+// sequential model of that range exactly.
+bool disjointKeysTest(int threads, int opsPerThread) {
+    ConcurrentSkipList list;
+    const int keysPerThread = 512;
+    vector<set<int>> models(threads);
+    atomic<bool> failed(false);
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            uint64_t rng = 1234567 + t;
+            set<int>& model = models[t];
+            for (int i = 0; i < opsPerThread; i++) {
+                int key = t * keysPerThread + int(nextRandom(rng) % keysPerThread);
+                int op = int(nextRandom(rng) % 3);
+                bool expected, actual;
+                if (op == 0) {
+                    expected = model.insert(key).second;
+                    actual = list.insert(key);
+                } else if (op == 1) {
+                    expected = model.erase(key) == 1;
+                    actual = list.remove(key);
+                } else {
+                    expected = model.count(key) == 1;
+                    actual = list.search(key);
+                }
+                if (expected != actual)
+                    failed = true;
+            }
+        });
+    }
+    for (thread& worker : workers)
+        worker.join();
+
+    set<int> merged;
+    for (const set<int>& model : models)
+        merged.insert(model.begin(), model.end());
+    vector<int> contents = list.snapshot();
+    return !failed && contents == vector<int>(merged.begin(), merged.end()) &&
+           list.size() == (long long)merged.size();
+}
+
+// All threads fight over keyRange keys. For every key, successful inserts
+// minus successful removes must equal its final presence (0 or 1), and the
+// list must end up sorted without duplicates. With a handful of keys most
+// inserts land next to a marked node of the same value that is still being
+// unlinked, which is where removal and reclamation are easiest to get wrong.
+bool contendedKeysTest(int threads, int opsPerThread, int keyRange) {
+    ConcurrentSkipList list;
+    vector<vector<long long>> balance(threads, vector<long long>(keyRange, 0));
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            uint64_t rng = 7654321 + t;
+            for (int i = 0; i < opsPerThread; i++) {
+                int key = int(nextRandom(rng) % keyRange);
+                switch (nextRandom(rng) % 3) {
+                    case 0: balance[t][key] += list.insert(key); break;
+                    case 1: balance[t][key] -= list.remove(key); break;
+                    default: list.search(key);
+                }
+            }
+        });
+    }
+    for (thread& worker : workers)
+        worker.join();
+
+    string error;
+    if (!list.validate(&error)) {
+        cout << "  " << error << endl;
+        return false;
+    }
+    vector<int> contents = list.snapshot();
+    for (size_t i = 1; i < contents.size(); i++)
+        if (contents[i - 1] >= contents[i])
+            return false;
+
+    for (int key = 0; key < keyRange; key++) {
+        long long net = 0;
+        for (int t = 0; t < threads; t++)
+            net += balance[t][key];
+        bool present = list.search(key);
+        if (net != (present ? 1 : 0))
+            return false;
+    }
+    return list.size() == (long long)contents.size();
+}
+
+// Mixed workload: 80% search, 10% insert, 10% remove over a fixed key range
+double measureThroughput(int threads, int keyRange, chrono::milliseconds duration) {
+    ConcurrentSkipList list;
+    for (int key = 0; key < keyRange; key += 2)
+        list.insert(key);
+
+    atomic<bool> stop(false);
+    vector<long long> operations(threads, 0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            uint64_t rng = 99991 + t;
+            long long done = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                for (int i = 0; i < 256; i++) {
+                    uint64_t r = nextRandom(rng);
+                    int key = int(r % keyRange);
+                    int op = int((r >> 32) % 10);
+                    if (op == 0)
+                        list.insert(key);
+                    else if (op == 1)
+                        list.remove(key);
+                    else
+                        list.search(key);
+                }
+                done += 256;
+            }
+            operations[t] = done;
+        });
+    }
+
+    this_thread::sleep_for(duration);
+    stop = true;
+    for (thread& worker : workers)
+        worker.join();
+
+    long long total = 0;
+    for (long long done : operations)
+        total += done;
+    return total / chrono::duration<double>(duration).count() / 1e6;
+}
+
+// Usage: ./ConcurrentSkipList [maxThreads]
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : int(thread::hardware_concurrency());
+    if (maxThreads < 1)
+        maxThreads = 1;
+    if (maxThreads > MAX_THREADS / 2)
+        maxThreads = MAX_THREADS / 2;
+    int stressThreads = maxThreads < 4 ? 4 : maxThreads;
+
+    cout << "Disjoint-key stress test (" << stressThreads << " threads): "
+         << (disjointKeysTest(stressThreads, 200000) ? "passed" : "FAILED") << endl;
+    cout << "Contended-key stress test (" << stressThreads << " threads, 64 keys): "
+         << (contendedKeysTest(stressThreads, 200000, 64) ? "passed" : "FAILED") << endl;
+    int sameKeyThreads = stressThreads < 16 ? 16 : stressThreads;
+    cout << "Same-key stress test (" << sameKeyThreads << " threads, 4 keys): "
+         << (contendedKeysTest(sameKeyThreads, 100000, 4) ? "passed" : "FAILED") << endl;
+
+    cout << "\nThroughput, 80% search / 10% insert / 10% remove, 1M keys:" << endl;
+    cout << setw(8) << "threads" << setw(12) << "Mops/s" << endl;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double mops = measureThroughput(threads, 1000000, chrono::milliseconds(1000));
+        cout << setw(8) << threads << setw(12) << fixed << setprecision(2) << mops << endl;
+    }
+
+    return 0;
+}
+#endif // CONCURRENT_SKIPLIST_NO_MAIN
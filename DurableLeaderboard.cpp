@@ -0,0 +1,779 @@
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+#define PLAYERS_NO_MAIN
+#include "PlayersProbUsingSkipList.cpp"
+#include "BenchmarkUtil.h"
+
+// Crash-safe wrapper around the leaderboard in PlayersProbUsingSkipList.cpp.
+//
+// Every addPlayer/updateScore/removePlayer is applied in memory and appended
+// to a write-ahead log buffer. A commit thread writes the buffer and calls
+// fdatasync for all callers waiting at that moment (group commit), so many
+// concurrent updates share one disk flush.
+//
+// An update is visible to readers as soon as it is applied, which is before
+// it is durable; with syncCommit the caller is told about success only once
+// its record is on disk. If a log write or fdatasync fails, the log is cut
+// back to the end of the last good commit and the leaderboard stops: every
+// later update and checkpoint is refused, and waiting callers get false. The
+// in-memory board may then hold updates the log lost, so the process has to
+// reopen the directory to continue from what is actually durable.
+//
+// checkpoint() writes the whole board, in leaderboard order, to a snapshot
+// file (temp file + rename) and starts a fresh log. Recovery maps the
+// snapshot, rebuilds the board with SkipList::loadSorted in linear time and
+// replays only the log records newer than the snapshot.
+//
+// Files in the data directory:
+//   leaderboard.snap     LeaderboardSnapshotHeader + count SnapshotRecord entries
+//   leaderboard.wal      WalRecord entries since the last rotation
+//   leaderboard.wal.old  the previous log, kept until the snapshot covering it is durable
+
+struct LeaderboardSnapshotHeader
+{
+    char magic[4];        // "LBS1"
+    uint32_t recordBytes; // sizeof(SnapshotRecord) of the writer
+    uint64_t count;
+    uint64_t lastLsn; // Every log record up to this sequence number is in the snapshot
+};
+
+struct SnapshotRecord
+{
+    int32_t playerId;
+    int32_t score;
+};
+
+enum WalOp
+{
+    WAL_ADD = 1,
+    WAL_UPDATE = 2,
+    WAL_REMOVE = 3
+};
+
+struct WalRecord
+{
+    uint64_t lsn; // Log sequence number, strictly increasing across files
+    int32_t op;
+    int32_t playerId;
+    int32_t score;
+    uint32_t checksum; // Detects a record torn by a crash mid-write
+};
+
+// FNV-1a over everything in the record before the checksum
+uint32_t walChecksum(const WalRecord &record)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&record);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(WalRecord, checksum); i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+struct RecoveryStats
+{
+    uint64_t snapshotPlayers = 0;
+    uint64_t replayedRecords = 0;
+    uint64_t skippedRecords = 0; // Already contained in the snapshot
+    double snapshotMs = 0;
+    double replayMs = 0;
+};
+
+class DurableLeaderboard
+{
+    string directory, snapshotPath, snapshotTempPath, walPath, walOldPath, walNewPath;
+    bool syncCommit; // Wait for fdatasync before an update returns
+    chrono::microseconds commitInterval;
+
+    SkipList board;
+    mutex stateLock; // Guards board, buffer and nextLsn
+    vector<WalRecord> buffer;
+    uint64_t nextLsn = 1;
+
+    mutex commitLock; // Held while log records are written; orders commits and rotation
+    int walFd = -1;
+    off_t walBytes = 0; // Length of the log after the last successful commit
+    vector<WalRecord> writing;
+    long long commits = 0;
+
+    mutex durableLock;
+    condition_variable durableChanged;
+    uint64_t durableLsn = 0;
+    bool failed = false; // A commit failed; no further updates are accepted
+
+    mutex checkpointLock;
+
+    mutex wakeLock;
+    condition_variable wake;
+    bool commitRequested = false;
+    bool stopping = false;
+    thread committer;
+
+    RecoveryStats recovery;
+
+    static bool writeAll(int fd, const void *data, size_t bytes)
+    {
+        const char *cursor = static_cast<const char *>(data);
+        while (bytes > 0)
+        {
+            ssize_t written = write(fd, cursor, bytes);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            cursor += written;
+            bytes -= written;
+        }
+        return true;
+    }
+
+    bool syncDirectory()
+    {
+        int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        bool ok = fsync(fd) == 0;
+        close(fd);
+        return ok;
+    }
+
+    bool logFailed()
+    {
+        lock_guard<mutex> guard(durableLock);
+        return failed;
+    }
+
+    // Caller holds commitLock. Writes whatever is buffered and makes it durable.
+    // A failure is permanent: the batch is not retried and the log is cut back
+    // to its last good length so a later recovery never sees part of it.
+    bool commitBuffered()
+    {
+        if (logFailed())
+        {
+            return false;
+        }
+        uint64_t lastLsn;
+        {
+            lock_guard<mutex> guard(stateLock);
+            buffer.swap(writing);
+            lastLsn = nextLsn - 1;
+        }
+
+        bool ok = true;
+        int error = 0;
+        if (!writing.empty())
+        {
+            size_t bytes = writing.size() * sizeof(WalRecord);
+            ok = writeAll(walFd, writing.data(), bytes) && fdatasync(walFd) == 0;
+            if (ok)
+            {
+                walBytes += bytes;
+            }
+            else
+            {
+                error = errno;
+                ftruncate(walFd, walBytes);
+            }
+            writing.clear();
+            commits++;
+        }
+
+        {
+            lock_guard<mutex> guard(durableLock);
+            if (ok)
+            {
+                durableLsn = lastLsn;
+            }
+            else
+            {
+                failed = true;
+            }
+        }
+        durableChanged.notify_all();
+        if (!ok)
+        {
+            cout << "Write-ahead log commit failed: " << strerror(error) << "; no further updates are accepted" << endl;
+        }
+        return ok;
+    }
+
+    void commitLoop()
+    {
+        unique_lock<mutex> guard(wakeLock);
+        while (!stopping)
+        {
+            wake.wait_for(guard, commitInterval, [this] { return stopping || commitRequested; });
+            commitRequested = false;
+            guard.unlock();
+            {
+                lock_guard<mutex> committing(commitLock);
+                commitBuffered();
+            }
+            guard.lock();
+        }
+    }
+
+    // Caller holds stateLock
+    uint64_t appendRecord(WalOp op, int playerId, int score)
+    {
+        WalRecord record{nextLsn++, op, playerId, score, 0};
+        record.checksum = walChecksum(record);
+        buffer.push_back(record);
+        return record.lsn;
+    }
+
+    // Returns once the record is on disk (or immediately without syncCommit)
+    bool waitDurable(uint64_t lsn)
+    {
+        if (!syncCommit)
+        {
+            return true;
+        }
+        {
+            lock_guard<mutex> guard(wakeLock);
+            commitRequested = true;
+        }
+        wake.notify_one();
+
+        unique_lock<mutex> guard(durableLock);
+        durableChanged.wait(guard, [&] { return durableLsn >= lsn || failed; });
+        return durableLsn >= lsn;
+    }
+
+    bool loadSnapshot(uint64_t &snapshotLsn)
+    {
+        int fd = ::open(snapshotPath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return errno == ENOENT; // No snapshot yet: start from an empty board
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(LeaderboardSnapshotHeader))
+        {
+            close(fd);
+            return false;
+        }
+        size_t length = info.st_size;
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            return false;
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+
+        const LeaderboardSnapshotHeader *header = static_cast<const LeaderboardSnapshotHeader *>(mapped);
+        const SnapshotRecord *records = reinterpret_cast<const SnapshotRecord *>(header + 1);
+        bool ok = memcmp(header->magic, "LBS1", 4) == 0 && header->recordBytes == sizeof(SnapshotRecord) &&
+                  header->count == (length - sizeof(LeaderboardSnapshotHeader)) / sizeof(SnapshotRecord) &&
+                  board.loadSorted(records, records + header->count);
+        if (ok)
+        {
+            snapshotLsn = header->lastLsn;
+            recovery.snapshotPlayers = header->count;
+        }
+        munmap(mapped, length);
+        return ok;
+    }
+
+    // Caller holds stateLock
+    void applyRecord(const WalRecord &record)
+    {
+        int score;
+        bool known = board.getScore(record.playerId, score);
+        if (record.op == WAL_REMOVE)
+        {
+            if (known)
+            {
+                board.removePlayer(record.playerId);
+            }
+        }
+        else if (known)
+        {
+            board.updateScore(record.playerId, record.score);
+        }
+        else
+        {
+            board.addPlayer(record.playerId, record.score);
+        }
+    }
+
+    // Apply the valid prefix of a log file and cut off a torn tail, if any.
+    // Sequence numbers must continue from lastLsn (the previous file) without
+    // a gap, and the first record after the snapshot must directly follow it;
+    // a gap means committed records are missing, so recovery fails.
+    bool replayLog(const string &path, uint64_t snapshotLsn, uint64_t &lastLsn)
+    {
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0)
+        {
+            return errno == ENOENT;
+        }
+
+        const size_t chunkRecords = 1 << 16;
+        vector<WalRecord> chunk(chunkRecords);
+        off_t validBytes = 0;
+        bool torn = false, gap = false;
+        while (!torn && !gap)
+        {
+            ssize_t got = pread(fd, chunk.data(), chunkRecords * sizeof(WalRecord), validBytes);
+            if (got <= 0)
+            {
+                break;
+            }
+            size_t whole = got / sizeof(WalRecord);
+            torn = whole * sizeof(WalRecord) != (size_t)got;
+            for (size_t i = 0; i < whole; i++)
+            {
+                const WalRecord &record = chunk[i];
+                if (record.checksum != walChecksum(record))
+                {
+                    torn = true;
+                    break;
+                }
+                // The oldest surviving log may start anywhere inside the snapshot
+                uint64_t expected = lastLsn != 0 ? lastLsn + 1 : min(record.lsn, snapshotLsn + 1);
+                if (record.lsn != expected)
+                {
+                    cout << "Log sequence gap in " << path << ": expected record " << expected << ", found "
+                         << record.lsn << endl;
+                    gap = true;
+                    break;
+                }
+                lastLsn = record.lsn;
+                validBytes += sizeof(WalRecord);
+                if (record.lsn <= snapshotLsn)
+                {
+                    recovery.skippedRecords++;
+                    continue;
+                }
+                applyRecord(record);
+                recovery.replayedRecords++;
+            }
+        }
+
+        bool ok = !gap && (!torn || ftruncate(fd, validBytes) == 0);
+        close(fd);
+        return ok;
+    }
+
+public:
+    DurableLeaderboard(bool syncCommit = true, chrono::microseconds commitInterval = chrono::milliseconds(2))
+        : syncCommit(syncCommit), commitInterval(commitInterval), board(24, 0.5, false)
+    {
+    }
+
+    ~DurableLeaderboard()
+    {
+        if (walFd < 0)
+        {
+            return;
+        }
+        {
+            lock_guard<mutex> guard(wakeLock);
+            stopping = true;
+        }
+        wake.notify_one();
+        committer.join();
+        {
+            lock_guard<mutex> committing(commitLock);
+            commitBuffered();
+        }
+        close(walFd);
+    }
+
+    DurableLeaderboard(const DurableLeaderboard &) = delete;
+    DurableLeaderboard &operator=(const DurableLeaderboard &) = delete;
+
+    // Recover the board stored in dir (created if missing) and start logging to it
+    bool open(const string &dir)
+    {
+        if (walFd >= 0)
+        {
+            cout << "Leaderboard is already open!" << endl;
+            return false;
+        }
+        directory = dir;
+        snapshotPath = dir + "/leaderboard.snap";
+        snapshotTempPath = snapshotPath + ".tmp";
+        walPath = dir + "/leaderboard.wal";
+        walOldPath = walPath + ".old";
+        walNewPath = walPath + ".new";
+        mkdir(dir.c_str(), 0755);
+
+        lock_guard<mutex> guard(stateLock);
+        auto started = chrono::steady_clock::now();
+        uint64_t snapshotLsn = 0;
+        if (!loadSnapshot(snapshotLsn))
+        {
+            cout << "Could not load snapshot " << snapshotPath << endl;
+            return false;
+        }
+        auto loaded = chrono::steady_clock::now();
+
+        uint64_t lastLsn = 0;
+        if (!replayLog(walOldPath, snapshotLsn, lastLsn) || !replayLog(walPath, snapshotLsn, lastLsn))
+        {
+            cout << "Could not replay write-ahead log in " << dir << endl;
+            return false;
+        }
+        recovery.snapshotMs = chrono::duration<double, milli>(loaded - started).count();
+        recovery.replayMs = chrono::duration<double, milli>(chrono::steady_clock::now() - loaded).count();
+
+        walFd = ::open(walPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (walFd < 0)
+        {
+            cout << "Could not open " << walPath << endl;
+            return false;
+        }
+        walBytes = lseek(walFd, 0, SEEK_END);
+        nextLsn = max(lastLsn, snapshotLsn) + 1;
+        durableLsn = nextLsn - 1;
+        committer = thread(&DurableLeaderboard::commitLoop, this);
+        return true;
+    }
+
+    bool addPlayer(int playerId, int initialScore)
+    {
+        uint64_t lsn;
+        {
+            lock_guard<mutex> guard(stateLock);
+            int score;
+            if (walFd < 0 || logFailed() || board.getScore(playerId, score))
+            {
+                return false;
+            }
+            board.addPlayer(playerId, initialScore);
+            lsn = appendRecord(WAL_ADD, playerId, initialScore);
+        }
+        return waitDurable(lsn);
+    }
+
+    bool updateScore(int playerId, int newScore)
+    {
+        uint64_t lsn;
+        {
+            lock_guard<mutex> guard(stateLock);
+            int score;
+            if (walFd < 0 || logFailed() || !board.getScore(playerId, score))
+            {
+                return false;
+            }
+            board.updateScore(playerId, newScore);
+            lsn = appendRecord(WAL_UPDATE, playerId, newScore);
+        }
+        return waitDurable(lsn);
+    }
+
+    bool removePlayer(int playerId)
+    {
+        uint64_t lsn;
+        {
+            lock_guard<mutex> guard(stateLock);
+            int score;
+            if (walFd < 0 || logFailed() || !board.getScore(playerId, score))
+            {
+                return false;
+            }
+            board.removePlayer(playerId);
+            lsn = appendRecord(WAL_REMOVE, playerId, 0);
+        }
+        return waitDurable(lsn);
+    }
+
+    // Write a snapshot of the current board and retire the log it makes redundant.
+    // Updates are blocked only while the board is copied, not while it is written.
+    bool checkpoint()
+    {
+        lock_guard<mutex> serial(checkpointLock);
+        vector<SnapshotRecord> records;
+        LeaderboardSnapshotHeader header;
+        memcpy(header.magic, "LBS1", 4);
+        header.recordBytes = sizeof(SnapshotRecord);
+
+        {
+            lock_guard<mutex> committing(commitLock);
+            {
+                lock_guard<mutex> guard(stateLock);
+                if (walFd < 0)
+                {
+                    return false;
+                }
+                header.lastLsn = nextLsn - 1;
+                records.reserve(board.size());
+                board.forEachPlayer([&records](int playerId, int score)
+                                    { records.push_back({playerId, score}); });
+            }
+            header.count = records.size();
+
+            // Everything up to lastLsn goes into the current log, which then
+            // becomes the old log unless an earlier one is still waiting for
+            // a snapshot (it is replaced only once this snapshot is durable)
+            if (!commitBuffered())
+            {
+                return false;
+            }
+            if (access(walOldPath.c_str(), F_OK) != 0)
+            {
+                int freshFd = ::open(walNewPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+                if (freshFd < 0 || rename(walPath.c_str(), walOldPath.c_str()) != 0 ||
+                    rename(walNewPath.c_str(), walPath.c_str()) != 0 || !syncDirectory())
+                {
+                    cout << "Could not rotate " << walPath << endl;
+                    if (freshFd >= 0)
+                    {
+                        close(freshFd);
+                    }
+                    return false;
+                }
+                close(walFd);
+                walFd = freshFd;
+                walBytes = 0;
+            }
+        }
+
+        int fd = ::open(snapshotTempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool ok = fd >= 0 && writeAll(fd, &header, sizeof(header)) &&
+                  writeAll(fd, records.data(), records.size() * sizeof(SnapshotRecord)) && fsync(fd) == 0;
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        ok = ok && rename(snapshotTempPath.c_str(), snapshotPath.c_str()) == 0 && syncDirectory();
+        if (!ok)
+        {
+            cout << "Could not write snapshot " << snapshotPath << endl;
+            return false;
+        }
+
+        // The snapshot now covers the old log; an unrotated current log is
+        // only skipped on replay until the next checkpoint rotates it
+        unlink(walOldPath.c_str());
+        syncDirectory();
+        return true;
+    }
+
+    int getRank(int playerId)
+    {
+        lock_guard<mutex> guard(stateLock);
+        return board.getRank(playerId);
+    }
+
+    bool getScore(int playerId, int &score)
+    {
+        lock_guard<mutex> guard(stateLock);
+        return board.getScore(playerId, score);
+    }
+
+    vector<LeaderboardEntry> getPage(int offset, int limit)
+    {
+        lock_guard<mutex> guard(stateLock);
+        return board.getPage(offset, limit);
+    }
+
+    int size()
+    {
+        lock_guard<mutex> guard(stateLock);
+        return board.size();
+    }
+
+    long long commitCount()
+    {
+        lock_guard<mutex> committing(commitLock);
+        return commits;
+    }
+
+    const RecoveryStats &lastRecovery() const
+    {
+        return recovery;
+    }
+};
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+vector<SnapshotRecord> contents(DurableLeaderboard &board)
+{
+    vector<SnapshotRecord> rows;
+    for (const LeaderboardEntry &entry : board.getPage(0, board.size()))
+    {
+        rows.push_back({entry.playerId, entry.score});
+    }
+    return rows;
+}
+
+bool sameContents(const vector<SnapshotRecord> &a, const vector<SnapshotRecord> &b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(SnapshotRecord)) == 0;
+}
+
+// Commit a few updates, then append a well-formed record that skips a sequence
+// number, as if a commit in between were lost. Recovery must refuse the log.
+bool gapRejected(const string &dir)
+{
+    for (const char *name : {"/leaderboard.snap", "/leaderboard.wal", "/leaderboard.wal.old"})
+    {
+        unlink((dir + name).c_str());
+    }
+    {
+        DurableLeaderboard board(true);
+        if (!board.open(dir) || !board.addPlayer(1, 10) || !board.addPlayer(2, 20) || !board.updateScore(1, 30))
+        {
+            return false;
+        }
+    }
+
+    WalRecord skipped{5, WAL_UPDATE, 2, 40, 0}; // Records 1-3 are on disk, 4 is missing
+    skipped.checksum = walChecksum(skipped);
+    int fd = open((dir + "/leaderboard.wal").c_str(), O_WRONLY | O_APPEND);
+    bool appended = fd >= 0 && write(fd, &skipped, sizeof(skipped)) == (ssize_t)sizeof(skipped);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    DurableLeaderboard reopened(true);
+    return appended && !reopened.open(dir);
+}
+
+// Usage: ./DurableLeaderboard [players] [dataDirectory]
+int main(int argc, char *argv[])
+{
+    int players = argc > 1 ? atoi(argv[1]) : 1000000;
+    string dir = argc > 2 ? argv[2] : "leaderboard_data";
+    for (const char *name : {"/leaderboard.snap", "/leaderboard.wal", "/leaderboard.wal.old"})
+    {
+        unlink((dir + name).c_str());
+    }
+    uint64_t rng = 42;
+
+    // Baseline: the same updates without any logging
+    {
+        SkipList plain(24, 0.5, false);
+        auto start = chrono::steady_clock::now();
+        for (int id = 0; id < players; id++)
+        {
+            plain.addPlayer(id, int(nextRandom(rng) % 1000000));
+        }
+        for (int i = 0; i < players; i++)
+        {
+            plain.updateScore(int(nextRandom(rng) % players), int(nextRandom(rng) % 1000000));
+        }
+        cout << "In-memory only:      " << fixed << setprecision(2) << 2.0 * players / secondsSince(start) / 1e6
+             << " M ops/s" << endl;
+    }
+
+    vector<SnapshotRecord> expected;
+    {
+        DurableLeaderboard board(false);
+        if (!board.open(dir))
+        {
+            return 1;
+        }
+        auto start = chrono::steady_clock::now();
+        for (int id = 0; id < players; id++)
+        {
+            board.addPlayer(id, int(nextRandom(rng) % 1000000));
+        }
+        for (int i = 0; i < players; i++)
+        {
+            board.updateScore(int(nextRandom(rng) % players), int(nextRandom(rng) % 1000000));
+        }
+        cout << "Logged, async commit: " << 2.0 * players / secondsSince(start) / 1e6 << " M ops/s ("
+             << board.commitCount() << " commits)" << endl;
+
+        start = chrono::steady_clock::now();
+        bool ok = board.checkpoint();
+        cout << "Checkpoint of " << board.size() << " players: " << (ok ? "" : "FAILED ")
+             << secondsSince(start) * 1000 << " ms" << endl;
+
+        // A log tail on top of the snapshot, including leaves and joins
+        for (int i = 0; i < players / 10; i++)
+        {
+            int id = int(nextRandom(rng) % players);
+            if (i % 10 == 0)
+            {
+                board.removePlayer(id);
+            }
+            else if (!board.updateScore(id, int(nextRandom(rng) % 1000000)))
+            {
+                board.addPlayer(id, int(nextRandom(rng) % 1000000));
+            }
+        }
+        expected = contents(board);
+    }
+
+    DurableLeaderboard board(true);
+    auto start = chrono::steady_clock::now();
+    if (!board.open(dir))
+    {
+        return 1;
+    }
+    const RecoveryStats &recovery = board.lastRecovery();
+    cout << "Recovery: " << secondsSince(start) * 1000 << " ms (snapshot of " << recovery.snapshotPlayers
+         << " players in " << recovery.snapshotMs << " ms, " << recovery.replayedRecords << " log records replayed in "
+         << recovery.replayMs << " ms)" << endl;
+    cout << "Recovered board matches: " << (sameContents(expected, contents(board)) ? "yes" : "NO") << endl;
+    bool gapOk = gapRejected(dir + "/gap_test");
+    cout << "Log with a sequence gap rejected: " << (gapOk ? "yes" : "NO") << endl;
+
+    // Group commit: concurrent synchronous updates share fdatasync calls
+    cout << "\nSynchronous commit, 2000 updates per thread:" << endl;
+    cout << setw(8) << "threads" << setw(12) << "ops/s" << setw(14) << "ops/commit" << endl;
+    for (int threads = 1; threads <= 16; threads *= 4)
+    {
+        long long commitsBefore = board.commitCount();
+        auto phaseStart = chrono::steady_clock::now();
+        vector<thread> writers;
+        for (int t = 0; t < threads; t++)
+        {
+            writers.emplace_back([&board, players, t]()
+                                 {
+                uint64_t local = 1000 + t;
+                for (int i = 0; i < 2000; i++)
+                {
+                    int id = int(nextRandom(local) % players);
+                    if (!board.updateScore(id, int(nextRandom(local) % 1000000)))
+                    {
+                        board.addPlayer(id, 0);
+                    }
+                } });
+        }
+        for (thread &writer : writers)
+        {
+            writer.join();
+        }
+        double seconds = secondsSince(phaseStart);
+        long long commits = board.commitCount() - commitsBefore;
+        cout << setw(8) << threads << setw(12) << setprecision(0) << threads * 2000 / seconds << setw(14)
+             << setprecision(1) << (commits ? threads * 2000.0 / commits : 0.0) << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,575 @@
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+#define PLAYERS_NO_MAIN
+#include "PlayersProbUsingSkipList.cpp"
+#include "BenchmarkUtil.h"
+
+// Write-combining front-end for the leaderboard in PlayersProbUsingSkipList.cpp.
+// Writers drop updates into per-thread shards, where repeated updates to the
+// same player collapse into one entry. A single applier thread swaps every
+// shard out at once, merges them and applies the batch to a back copy of the
+// board while readers keep using the front one; swapping the two publishes the
+// whole batch under a brief exclusive lock, after which the batch is replayed
+// on the old front so both copies match again. Readers (shared lock) never see
+// a batch partly applied, at the cost of keeping the board twice.
+// The applier runs at least every maxDelay, and a writer whose shard already
+// holds its share of maxPending distinct players waits for the applier, so how
+// stale a read can be is bounded by maxDelay plus the time to apply two batches
+// (the replay of the previous batch, then this one).
+
+enum CombineMode
+{
+    LAST_WRITE_WINS, // submit(id, score): the most recently submitted score is kept
+    ADDITIVE         // submit(id, delta): deltas are summed, unknown players start at 0
+};
+
+struct PendingUpdate
+{
+    long long value; // Score (last-write-wins) or accumulated delta (additive)
+    uint64_t seq;    // Global submission order, used to merge shards in last-write-wins mode
+};
+
+struct IngestStats
+{
+    long long submitted = 0; // Updates handed to submit()
+    long long applied = 0;   // Updates that reached the board after coalescing
+    long long batches = 0;
+    double maxStalenessMs = 0; // Longest time an update waited before being published
+};
+
+class LeaderboardIngest
+{
+    struct alignas(64) Shard
+    {
+        mutex lock;
+        unordered_map<int, PendingUpdate> pending;
+        chrono::steady_clock::time_point firstPendingAt; // Valid while pending is non-empty
+        long long submitted = 0;
+    };
+
+    CombineMode mode;
+    chrono::microseconds maxDelay;
+    size_t shardCapacity; // Distinct players a shard may hold before writers wait
+
+    vector<Shard> shards;
+    atomic<uint64_t> sequence{0};
+
+    unique_ptr<SkipList> front, back; // Readers use front; the applier alone touches back
+    mutable shared_mutex viewLock;     // Exclusive only while front and back are swapped
+    atomic<bool> applierWaiting{false}; // Holds new readers back so a stream of them cannot starve the applier
+
+    mutex applyLock; // Serialises draining between the applier thread and flush()
+    vector<unordered_map<int, PendingUpdate>> drained; // One per shard, reused between batches
+    unordered_map<int, PendingUpdate> batch;
+    IngestStats stats;
+
+    mutex wakeLock;
+    condition_variable wake;
+    atomic<bool> wakeRequested{false};
+    bool stopping = false;
+    thread applier;
+
+    static size_t threadSlot()
+    {
+        static atomic<size_t> nextSlot{0};
+        thread_local size_t slot = nextSlot.fetch_add(1);
+        return slot;
+    }
+
+    shared_lock<shared_mutex> readLock() const
+    {
+        while (applierWaiting.load(memory_order_acquire))
+        {
+            this_thread::yield();
+        }
+        return shared_lock<shared_mutex>(viewLock);
+    }
+
+    // Apply the merged batch to one copy of the board
+    void applyBatch(SkipList &board)
+    {
+        for (auto &entry : batch)
+        {
+            int playerId = entry.first;
+            int score;
+            bool known = board.getScore(playerId, score);
+            long long target = mode == ADDITIVE ? (known ? score : 0) + entry.second.value : entry.second.value;
+            if (known)
+            {
+                board.updateScore(playerId, clampScore(target));
+            }
+            else
+            {
+                board.addPlayer(playerId, clampScore(target));
+            }
+        }
+    }
+
+    // Take every shard's pending updates, merge them and apply the result
+    void drainAndApply()
+    {
+        lock_guard<mutex> applying(applyLock);
+        auto now = chrono::steady_clock::now();
+        auto oldest = now;
+
+        // Hold every shard lock across the swap so the batch is a consistent cut:
+        // submit() draws its sequence number under the shard lock, so everything
+        // drained here was submitted before anything left for the next batch
+        vector<unique_lock<mutex>> held;
+        held.reserve(shards.size());
+        for (Shard &shard : shards)
+        {
+            held.emplace_back(shard.lock);
+        }
+        for (size_t i = 0; i < shards.size(); i++)
+        {
+            Shard &shard = shards[i];
+            if (!shard.pending.empty() && shard.firstPendingAt < oldest)
+            {
+                oldest = shard.firstPendingAt;
+            }
+            stats.submitted += shard.submitted;
+            shard.submitted = 0;
+            shard.pending.swap(drained[i]);
+        }
+        held.clear();
+
+        for (auto &shardUpdates : drained)
+        {
+            for (auto &entry : shardUpdates)
+            {
+                auto merged = batch.emplace(entry.first, entry.second);
+                if (merged.second)
+                {
+                    continue;
+                }
+                PendingUpdate &current = merged.first->second;
+                if (mode == ADDITIVE)
+                {
+                    current.value += entry.second.value;
+                }
+                else if (entry.second.seq > current.seq)
+                {
+                    current = entry.second;
+                }
+            }
+            shardUpdates.clear(); // Keeps the buckets for the next batch
+        }
+
+        if (batch.empty())
+        {
+            return;
+        }
+
+        applyBatch(*back);
+        {
+            applierWaiting = true;
+            unique_lock<shared_mutex> exclusive(viewLock);
+            applierWaiting = false;
+            swap(front, back);
+        }
+
+        double waitedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - oldest).count();
+        applyBatch(*back); // No reader can still be on the old front once the swap has the lock
+
+        if (waitedMs > stats.maxStalenessMs)
+        {
+            stats.maxStalenessMs = waitedMs;
+        }
+        stats.applied += (long long)batch.size();
+        stats.batches++;
+        batch.clear();
+    }
+
+    void applierLoop()
+    {
+        unique_lock<mutex> guard(wakeLock);
+        while (!stopping)
+        {
+            wake.wait_for(guard, maxDelay, [this] { return stopping || wakeRequested.load(); });
+            wakeRequested = false;
+            guard.unlock();
+            drainAndApply();
+            guard.lock();
+        }
+    }
+
+public:
+    LeaderboardIngest(CombineMode mode, chrono::microseconds maxDelay = chrono::milliseconds(5),
+                      size_t maxPending = 1 << 15, size_t shardCount = 0)
+        : mode(mode), maxDelay(maxDelay),
+          shards(shardCount > 0 ? shardCount : 2 * max(1u, thread::hardware_concurrency())),
+          front(new SkipList(20, 0.5, false)), back(new SkipList(20, 0.5, false)), drained(shards.size())
+    {
+        shardCapacity = max<size_t>(64, maxPending / shards.size());
+        applier = thread(&LeaderboardIngest::applierLoop, this);
+    }
+
+    ~LeaderboardIngest()
+    {
+        {
+            lock_guard<mutex> guard(wakeLock);
+            stopping = true;
+        }
+        wake.notify_one();
+        applier.join();
+        drainAndApply();
+    }
+
+    LeaderboardIngest(const LeaderboardIngest &) = delete;
+    LeaderboardIngest &operator=(const LeaderboardIngest &) = delete;
+
+    // Queue a score (last-write-wins) or a delta (additive) for a player
+    void submit(int playerId, int value)
+    {
+        Shard &shard = shards[threadSlot() % shards.size()];
+        size_t pendingCount;
+        {
+            unique_lock<mutex> guard(shard.lock);
+            // Back-pressure: a full shard only accepts players it already holds
+            while (shard.pending.size() >= shardCapacity && shard.pending.count(playerId) == 0)
+            {
+                guard.unlock();
+                if (!wakeRequested.exchange(true))
+                {
+                    wake.notify_one();
+                }
+                this_thread::sleep_for(chrono::microseconds(50));
+                guard.lock();
+            }
+
+            // Drawn under the shard lock so that drainAndApply() sees sequence
+            // numbers in the order the updates reached the shards
+            uint64_t seq = mode == LAST_WRITE_WINS ? sequence.fetch_add(1, memory_order_relaxed) : 0;
+            if (shard.pending.empty())
+            {
+                shard.firstPendingAt = chrono::steady_clock::now();
+            }
+            auto inserted = shard.pending.emplace(playerId, PendingUpdate{value, seq});
+            if (!inserted.second)
+            {
+                PendingUpdate &current = inserted.first->second;
+                if (mode == ADDITIVE)
+                {
+                    current.value += value;
+                }
+                else if (seq > current.seq)
+                {
+                    current = PendingUpdate{value, seq};
+                }
+            }
+            shard.submitted++;
+            pendingCount = shard.pending.size();
+        }
+
+        // Start applying early once a shard is half full
+        if (pendingCount >= shardCapacity / 2 && !wakeRequested.exchange(true))
+        {
+            wake.notify_one();
+        }
+    }
+
+    // Apply everything submitted before this call; afterwards reads reflect it
+    void flush()
+    {
+        drainAndApply();
+    }
+
+    // Reads see the board as of the last published batch
+
+    int getRank(int playerId) const
+    {
+        auto guard = readLock();
+        return front->getRank(playerId);
+    }
+
+    bool getScore(int playerId, int &score) const
+    {
+        auto guard = readLock();
+        return front->getScore(playerId, score);
+    }
+
+    vector<LeaderboardEntry> getAround(int playerId, int k) const
+    {
+        auto guard = readLock();
+        return front->getAround(playerId, k);
+    }
+
+    vector<LeaderboardEntry> getPage(int offset, int limit) const
+    {
+        auto guard = readLock();
+        return front->getPage(offset, limit);
+    }
+
+    int size() const
+    {
+        auto guard = readLock();
+        return front->size();
+    }
+
+    IngestStats getStats()
+    {
+        lock_guard<mutex> applying(applyLock);
+        return stats;
+    }
+};
+
+// Every thread adds deltas to every player; the final scores must equal the sums
+bool additiveTest(int threads, int players, int updatesPerThread)
+{
+    vector<vector<long long>> sums(threads, vector<long long>(players, 0));
+    {
+        LeaderboardIngest ingest(ADDITIVE, chrono::milliseconds(1));
+        vector<thread> writers;
+        for (int t = 0; t < threads; t++)
+        {
+            writers.emplace_back([&, t]()
+                                 {
+                uint64_t rng = 1000 + t;
+                for (int i = 0; i < updatesPerThread; i++)
+                {
+                    int playerId = int(nextRandom(rng) % players);
+                    int delta = int(nextRandom(rng) % 21) - 10;
+                    ingest.submit(playerId, delta);
+                    sums[t][playerId] += delta;
+                } });
+        }
+        for (thread &writer : writers)
+        {
+            writer.join();
+        }
+        ingest.flush();
+
+        for (int playerId = 0; playerId < players; playerId++)
+        {
+            long long expected = 0;
+            bool touched = false;
+            for (int t = 0; t < threads; t++)
+            {
+                expected += sums[t][playerId];
+            }
+            for (int t = 0; t < threads && !touched; t++)
+            {
+                touched = sums[t][playerId] != 0;
+            }
+            int score;
+            if (ingest.getScore(playerId, score) ? score != expected : touched)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Threads own disjoint players, so each player's last submitted score must win
+bool lastWriteWinsTest(int threads, int playersPerThread, int updatesPerThread)
+{
+    vector<vector<int>> last(threads, vector<int>(playersPerThread, INT_MIN));
+    LeaderboardIngest ingest(LAST_WRITE_WINS, chrono::milliseconds(1));
+    vector<thread> writers;
+    for (int t = 0; t < threads; t++)
+    {
+        writers.emplace_back([&, t]()
+                             {
+            uint64_t rng = 2000 + t;
+            for (int i = 0; i < updatesPerThread; i++)
+            {
+                int slot = int(nextRandom(rng) % playersPerThread);
+                int score = int(nextRandom(rng) % 100000);
+                ingest.submit(t * playersPerThread + slot, score);
+                last[t][slot] = score;
+            } });
+    }
+    for (thread &writer : writers)
+    {
+        writer.join();
+    }
+    ingest.flush();
+
+    for (int t = 0; t < threads; t++)
+    {
+        for (int slot = 0; slot < playersPerThread; slot++)
+        {
+            int score = 0;
+            bool present = ingest.getScore(t * playersPerThread + slot, score);
+            if (present != (last[t][slot] != INT_MIN) || (present && score != last[t][slot]))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Published pages must be in leaderboard order with consecutive ranks
+    vector<LeaderboardEntry> page = ingest.getPage(0, ingest.size());
+    for (size_t i = 1; i < page.size(); i++)
+    {
+        const LeaderboardEntry &a = page[i - 1], &b = page[i];
+        bool ordered = a.score > b.score || (a.score == b.score && a.playerId < b.playerId);
+        if (!ordered || b.rank != a.rank + 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Threads take turns writing one player, each score higher than the last and
+// submitted only after the previous write returned. With a shard per thread and
+// a short maxDelay consecutive writes land in different shards while batches
+// are being drained. The writes come in short rounds; after each round the
+// board must hold exactly the round's last score
+bool sameKeyOrderedTest(int threads, int rounds, int writesPerRound)
+{
+    LeaderboardIngest ingest(LAST_WRITE_WINS, chrono::microseconds(1), 1 << 20, threads);
+    int writes = rounds * writesPerRound;
+    atomic<int> turn{0}, released{0};
+    vector<thread> writers;
+    for (int t = 0; t < threads; t++)
+    {
+        writers.emplace_back([&, t]()
+                             {
+            for (int i = t; i < writes; i += threads)
+            {
+                while (turn.load(memory_order_acquire) != i || released.load(memory_order_acquire) <= i)
+                {
+                    this_thread::yield();
+                }
+                ingest.submit(42, i);
+                turn.store(i + 1, memory_order_release);
+            } });
+    }
+    bool ordered = true;
+    for (int round = 1; round <= rounds; round++)
+    {
+        int last = round * writesPerRound;
+        released.store(last, memory_order_release);
+        while (turn.load(memory_order_acquire) < last)
+        {
+            this_thread::yield();
+        }
+        ingest.flush();
+        int score = -1;
+        ordered = ordered && ingest.getScore(42, score) && score == last - 1;
+    }
+    for (thread &writer : writers)
+    {
+        writer.join();
+    }
+    return ordered;
+}
+
+// Writers hammer a skewed set of players while readers page through the board
+void measureThroughput(int writerThreads, int readerThreads, int players, chrono::milliseconds duration)
+{
+    LeaderboardIngest ingest(LAST_WRITE_WINS, chrono::milliseconds(5));
+    atomic<bool> stop(false);
+    vector<long long> writes(writerThreads, 0), reads(readerThreads, 0);
+    vector<thread> threads;
+
+    for (int t = 0; t < writerThreads; t++)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            uint64_t rng = 3000 + t;
+            long long done = 0;
+            while (!stop.load(memory_order_relaxed))
+            {
+                for (int i = 0; i < 256; i++)
+                {
+                    uint64_t r = nextRandom(rng);
+                    // Half the traffic goes to the top 1% of players
+                    int hot = max(1, players / 100);
+                    int playerId = (r & 1) ? int((r >> 1) % hot) : int((r >> 1) % players);
+                    ingest.submit(playerId, int((r >> 32) % 1000000));
+                }
+                done += 256;
+            }
+            writes[t] = done; });
+    }
+    for (int t = 0; t < readerThreads; t++)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            uint64_t rng = 4000 + t;
+            long long done = 0;
+            while (!stop.load(memory_order_relaxed))
+            {
+                if (nextRandom(rng) & 1)
+                {
+                    ingest.getPage(0, 10);
+                }
+                else
+                {
+                    ingest.getAround(int(nextRandom(rng) % players), 5);
+                }
+                done++;
+            }
+            reads[t] = done; });
+    }
+
+    this_thread::sleep_for(duration);
+    stop = true;
+    for (thread &worker : threads)
+    {
+        worker.join();
+    }
+    ingest.flush();
+
+    long long totalWrites = 0, totalReads = 0;
+    for (long long done : writes)
+    {
+        totalWrites += done;
+    }
+    for (long long done : reads)
+    {
+        totalReads += done;
+    }
+    double seconds = chrono::duration<double>(duration).count();
+    IngestStats stats = ingest.getStats();
+
+    cout << setw(8) << writerThreads << setw(8) << readerThreads
+         << setw(14) << fixed << setprecision(2) << totalWrites / seconds / 1e6
+         << setw(14) << totalReads / seconds / 1e3
+         << setw(12) << setprecision(1) << (stats.applied ? double(stats.submitted) / stats.applied : 0.0)
+         << setw(10) << stats.batches
+         << setw(16) << setprecision(2) << stats.maxStalenessMs << endl;
+}
+
+// Usage: ./LeaderboardIngest [maxWriterThreads]
+int main(int argc, char *argv[])
+{
+    int maxWriters = argc > 1 ? atoi(argv[1]) : int(thread::hardware_concurrency());
+    if (maxWriters < 1)
+    {
+        maxWriters = 1;
+    }
+
+    cout << "Additive coalescing test: " << (additiveTest(4, 5000, 200000) ? "passed" : "FAILED") << endl;
+    cout << "Last-write-wins test: " << (lastWriteWinsTest(4, 5000, 200000) ? "passed" : "FAILED") << endl;
+    cout << "Same-player ordered writes test: " << (sameKeyOrderedTest(4, 20000, 16) ? "passed" : "FAILED") << endl;
+
+    cout << "\nLast-write-wins ingest, 1M players, 2 reader threads:" << endl;
+    cout << setw(8) << "writers" << setw(8) << "readers" << setw(14) << "updates M/s"
+         << setw(14) << "reads K/s" << setw(12) << "coalesce" << setw(10) << "batches"
+         << setw(16) << "max stale ms" << endl;
+    for (int writers = 1; writers <= maxWriters; writers *= 2)
+    {
+        measureThroughput(writers, 2, 1000000, chrono::milliseconds(1000));
+    }
+
+    return 0;
+}
@@ -0,0 +1,448 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+
+#define PLAYERS_NO_MAIN
+#include "PlayersProbUsingSkipList.cpp"
+#include "BenchmarkUtil.h"
+
+// Load generator and replay harness for the leaderboard in
+// PlayersProbUsingSkipList.cpp. A run first generates a trace of operations:
+// an untimed setup phase that joins the initial players, then a mix of score
+// updates (Zipf-skewed towards hot players), joins and leaves, top-N reads and
+// score lookups. The trace is then executed against a fresh board and every
+// operation is timed into a per-type log-linear latency histogram. A trace
+// can be saved and replayed later. Replays rebuild the board with the same
+// seed and print a checksum of everything the reads returned, so two runs of
+// one trace can be compared directly.
+//
+// Usage: ./LeaderboardLoadGen [--players N] [--ops N] [--zipf THETA] [--churn F]
+//                             [--reads F] [--top-share F] [--top-n N] [--seed S]
+//                             [--record FILE | --replay FILE]
+//   churn     fraction of operations that are joins or leaves (half each)
+//   reads     fraction of operations that are reads
+//   top-share fraction of reads that fetch the top N; the rest look up one score
+//   zipf      skew of update and lookup targets, 0 <= THETA < 1 (0 = uniform)
+
+enum TraceOp
+{
+    OP_JOIN,
+    OP_LEAVE,
+    OP_UPDATE,
+    OP_TOP_N,
+    OP_SCORE,
+    OP_COUNT
+};
+
+const char *const OP_NAMES[OP_COUNT] = {"join", "leave", "update", "top-n", "score"};
+
+// On-disk layout of a trace: this header followed by `count` TraceRecord
+// entries (host byte order), the first `setupCount` of which are the initial joins
+struct TraceHeader
+{
+    char magic[4];        // "LBT1"
+    uint32_t recordBytes; // sizeof(TraceRecord) of the writer
+    uint64_t setupCount;
+    uint64_t count;
+    uint64_t seed; // Seeds the board's level generator on replay
+};
+
+struct TraceRecord
+{
+    int32_t op;
+    int32_t playerId;
+    int32_t value; // New score for join/update, N for top-N, unused otherwise
+};
+
+struct LoadConfig
+{
+    int players = 100000;
+    long long operations = 1000000;
+    double zipfTheta = 0.99;
+    double churn = 0.02;
+    double reads = 0.5;
+    double topShare = 0.2;
+    int topN = 10;
+    uint64_t seed = 1;
+    string recordPath, replayPath;
+};
+
+// Log-linear histogram in the style of HdrHistogram: values below 2^SUB_BITS
+// are counted exactly, and every power of two above that is split into
+// 2^SUB_BITS equal sub-buckets. Reported values are therefore within about 3%.
+class LatencyHistogram
+{
+    static const int SUB_BITS = 5;
+    static const uint64_t SUB_COUNT = 1 << SUB_BITS;
+
+    vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+    double sum = 0;
+
+    static size_t bucketOf(uint64_t value)
+    {
+        if (value < SUB_COUNT)
+        {
+            return value;
+        }
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - SUB_BITS;
+        return SUB_COUNT + shift * SUB_COUNT + ((value >> shift) - SUB_COUNT);
+    }
+
+    // Largest value that lands in the bucket
+    static uint64_t bucketTop(size_t bucket)
+    {
+        if (bucket < SUB_COUNT)
+        {
+            return bucket;
+        }
+        int shift = int((bucket - SUB_COUNT) / SUB_COUNT);
+        uint64_t sub = (bucket - SUB_COUNT) % SUB_COUNT;
+        return ((SUB_COUNT + sub + 1) << shift) - 1;
+    }
+
+public:
+    LatencyHistogram() : counts(SUB_COUNT + (64 - SUB_BITS) * SUB_COUNT, 0) {}
+
+    void record(uint64_t value)
+    {
+        counts[bucketOf(value)]++;
+        total++;
+        sum += value;
+        if (value > maxValue)
+        {
+            maxValue = value;
+        }
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return total ? sum / total : 0; }
+
+    // Smallest bucket value at or below which `percentile` percent of samples fall
+    uint64_t valueAtPercentile(double percentile) const
+    {
+        if (total == 0)
+        {
+            return 0;
+        }
+        uint64_t target = (uint64_t)ceil(percentile / 100.0 * total);
+        if (target == 0)
+        {
+            target = 1;
+        }
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < counts.size(); bucket++)
+        {
+            seen += counts[bucket];
+            if (seen >= target)
+            {
+                return min(bucketTop(bucket), maxValue);
+            }
+        }
+        return maxValue;
+    }
+};
+
+// Build a trace that is valid by construction: leaves, updates and lookups
+// only name players that are on the board at that point
+vector<TraceRecord> generateTrace(const LoadConfig &config, uint64_t &setupCount)
+{
+    mt19937_64 rng(config.seed);
+    uniform_int_distribution<int> initialScore(0, 1000000);
+    uniform_int_distribution<int> scoreDelta(-100, 500);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    ZipfGenerator zipf(max(config.players, 1), config.zipfTheta);
+
+    vector<TraceRecord> trace;
+    trace.reserve(config.players + config.operations);
+    vector<int> live;       // Players on the board; low positions are the hot ones
+    vector<int> positionOf; // Index into live by playerId, -1 once left
+    vector<int> scoreOf;    // Current score by playerId
+
+    auto join = [&](int score)
+    {
+        int playerId = (int)scoreOf.size();
+        positionOf.push_back((int)live.size());
+        live.push_back(playerId);
+        scoreOf.push_back(score);
+        trace.push_back({OP_JOIN, playerId, score});
+    };
+    // Ranks cover exactly the live players, so churn never folds cold ranks onto hot ones
+    auto pickHot = [&]()
+    {
+        if (zipf.size() != (long long)live.size())
+        {
+            zipf.resize(live.size());
+        }
+        return live[zipf.next(rng)];
+    };
+
+    for (int i = 0; i < config.players; i++)
+    {
+        join(initialScore(rng));
+    }
+    setupCount = trace.size();
+
+    for (long long i = 0; i < config.operations; i++)
+    {
+        double choice = unit(rng);
+        if (choice < config.churn || live.empty())
+        {
+            if (choice < config.churn / 2 || live.empty())
+            {
+                join(initialScore(rng));
+            }
+            else
+            {
+                // Leaving players are picked uniformly; the last live player fills the gap
+                int position = int(rng() % live.size());
+                int playerId = live[position];
+                live[position] = live.back();
+                positionOf[live[position]] = position;
+                live.pop_back();
+                positionOf[playerId] = -1;
+                trace.push_back({OP_LEAVE, playerId, 0});
+            }
+        }
+        else if (choice < config.churn + config.reads)
+        {
+            if (unit(rng) < config.topShare)
+            {
+                trace.push_back({OP_TOP_N, -1, config.topN});
+            }
+            else
+            {
+                trace.push_back({OP_SCORE, pickHot(), 0});
+            }
+        }
+        else
+        {
+            int playerId = pickHot();
+            scoreOf[playerId] += scoreDelta(rng);
+            trace.push_back({OP_UPDATE, playerId, scoreOf[playerId]});
+        }
+    }
+    return trace;
+}
+
+bool saveTrace(const string &path, const vector<TraceRecord> &trace, uint64_t setupCount, uint64_t seed)
+{
+    TraceHeader header;
+    memcpy(header.magic, "LBT1", 4);
+    header.recordBytes = sizeof(TraceRecord);
+    header.setupCount = setupCount;
+    header.count = trace.size();
+    header.seed = seed;
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out)
+    {
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(trace.data()), trace.size() * sizeof(TraceRecord));
+    return bool(out);
+}
+
+bool loadTrace(const string &path, vector<TraceRecord> &trace, uint64_t &setupCount, uint64_t &seed)
+{
+    ifstream in(path, ios::binary);
+    TraceHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) || memcmp(header.magic, "LBT1", 4) != 0 ||
+        header.recordBytes != sizeof(TraceRecord) || header.setupCount > header.count)
+    {
+        return false;
+    }
+    trace.resize(header.count);
+    if (!in.read(reinterpret_cast<char *>(trace.data()), trace.size() * sizeof(TraceRecord)))
+    {
+        return false;
+    }
+    setupCount = header.setupCount;
+    seed = header.seed;
+    return true;
+}
+
+struct RunResult
+{
+    LatencyHistogram latency[OP_COUNT];
+    double seconds = 0;
+    uint64_t checksum = 1469598103934665603ULL; // FNV-1a over every read result
+};
+
+void mix(uint64_t &checksum, int value)
+{
+    checksum = (checksum ^ uint32_t(value)) * 1099511628211ULL;
+}
+
+void runTrace(const vector<TraceRecord> &trace, uint64_t setupCount, uint64_t seed, RunResult &result)
+{
+    srand((unsigned)seed); // Same towers on every replay
+    SkipList board(24, 0.5, false);
+    for (uint64_t i = 0; i < setupCount; i++)
+    {
+        board.addPlayer(trace[i].playerId, trace[i].value);
+    }
+
+    auto runStart = chrono::steady_clock::now();
+    for (uint64_t i = setupCount; i < trace.size(); i++)
+    {
+        const TraceRecord &record = trace[i];
+        auto start = chrono::steady_clock::now();
+        switch (record.op)
+        {
+        case OP_JOIN:
+            board.addPlayer(record.playerId, record.value);
+            break;
+        case OP_LEAVE:
+            board.removePlayer(record.playerId);
+            break;
+        case OP_UPDATE:
+            board.updateScore(record.playerId, record.value);
+            break;
+        case OP_TOP_N:
+            for (const LeaderboardEntry &entry : board.getPage(0, record.value))
+            {
+                mix(result.checksum, entry.playerId);
+            }
+            break;
+        case OP_SCORE:
+        {
+            int score = 0;
+            mix(result.checksum, board.getScore(record.playerId, score) ? score : -1);
+            break;
+        }
+        }
+        auto end = chrono::steady_clock::now();
+        if (record.op >= 0 && record.op < OP_COUNT)
+        {
+            result.latency[record.op].record(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+        }
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - runStart).count();
+}
+
+void printReport(const RunResult &result, uint64_t operations)
+{
+    cout << setw(8) << "op" << setw(12) << "count" << setw(10) << "mean" << setw(10) << "p50" << setw(10) << "p99"
+         << setw(10) << "p99.9" << setw(12) << "max" << "   (ns)" << endl;
+    for (int op = 0; op < OP_COUNT; op++)
+    {
+        const LatencyHistogram &histogram = result.latency[op];
+        if (histogram.count() == 0)
+        {
+            continue;
+        }
+        cout << setw(8) << OP_NAMES[op] << setw(12) << histogram.count() << setw(10) << fixed << setprecision(0)
+             << histogram.mean() << setw(10) << histogram.valueAtPercentile(50) << setw(10)
+             << histogram.valueAtPercentile(99) << setw(10) << histogram.valueAtPercentile(99.9) << setw(12)
+             << histogram.max() << endl;
+    }
+    cout << "Throughput: " << setprecision(3) << operations / result.seconds / 1e6
+         << " M ops/s (including timer overhead)" << endl;
+    cout << "Result checksum: " << hex << result.checksum << dec << endl;
+}
+
+bool parseArguments(int argc, char *argv[], LoadConfig &config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string flag = argv[i];
+        if (i + 1 >= argc)
+        {
+            cout << "Missing value for " << flag << endl;
+            return false;
+        }
+        const char *value = argv[++i];
+        if (flag == "--players")
+            config.players = atoi(value);
+        else if (flag == "--ops")
+            config.operations = atoll(value);
+        else if (flag == "--zipf")
+            config.zipfTheta = atof(value);
+        else if (flag == "--churn")
+            config.churn = atof(value);
+        else if (flag == "--reads")
+            config.reads = atof(value);
+        else if (flag == "--top-share")
+            config.topShare = atof(value);
+        else if (flag == "--top-n")
+            config.topN = atoi(value);
+        else if (flag == "--seed")
+            config.seed = strtoull(value, nullptr, 10);
+        else if (flag == "--record")
+            config.recordPath = value;
+        else if (flag == "--replay")
+            config.replayPath = value;
+        else
+        {
+            cout << "Unknown option " << flag << endl;
+            return false;
+        }
+    }
+
+    if (config.players < 0 || config.operations < 0 || config.zipfTheta < 0 || config.zipfTheta >= 1 ||
+        config.churn < 0 || config.reads < 0 || config.churn + config.reads > 1 || config.topN < 0)
+    {
+        cout << "Invalid workload: need players, ops, top-n >= 0, 0 <= zipf < 1 and churn + reads <= 1" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    LoadConfig config;
+    if (!parseArguments(argc, argv, config))
+    {
+        return 1;
+    }
+
+    vector<TraceRecord> trace;
+    uint64_t setupCount = 0;
+    uint64_t seed = config.seed;
+    if (!config.replayPath.empty())
+    {
+        if (!loadTrace(config.replayPath, trace, setupCount, seed))
+        {
+            cout << "Could not read trace " << config.replayPath << endl;
+            return 1;
+        }
+        cout << "Replaying " << config.replayPath << ": " << setupCount << " initial players, "
+             << trace.size() - setupCount << " operations" << endl;
+    }
+    else
+    {
+        trace = generateTrace(config, setupCount);
+        cout << "Generated " << setupCount << " initial players, " << trace.size() - setupCount
+             << " operations (zipf " << config.zipfTheta << ", churn " << config.churn << ", reads "
+             << config.reads << ", top-n share " << config.topShare << ")" << endl;
+        if (!config.recordPath.empty())
+        {
+            if (!saveTrace(config.recordPath, trace, setupCount, seed))
+            {
+                cout << "Could not write trace " << config.recordPath << endl;
+                return 1;
+            }
+            cout << "Recorded trace to " << config.recordPath << endl;
+        }
+    }
+
+    RunResult result;
+    runTrace(trace, setupCount, seed, result);
+    printReport(result, trace.size() - setupCount);
+
+    return 0;
+}
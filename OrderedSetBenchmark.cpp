@@ -0,0 +1,376 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <limits>
+#include <new>
+#include <queue>
+#include <deque>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+#include <atomic>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Each structure lives in its own namespace: the programs were written to be
+// built alone and reuse names such as Node and CACHE_LINE. The headers they
+// need are all included above, so the nested includes are no-ops.
+namespace rbt {
+#define RBT_NO_MAIN
+#include "RBT.cpp"
+}
+namespace sl {
+#define SKIPLIST_NO_MAIN
+#include "SkipList.cpp"
+}
+namespace bpt {
+#define BPLUSTREE_NO_MAIN
+#include "BPlusTree.cpp"
+}
+
+#define BENCHMARK_HEAP_ACCOUNTING
+#include "BenchmarkUtil.h"
+
+using namespace std;
+
+// Runs the same workloads against SkipList, RBTree, BPlusTree and std::set.
+// Usage: ./OrderedSetBenchmark [n1 n2 ...]   (default sizes 1000 10000 100000 1000000)
+
+// ---- Hardware cache-miss counter (Linux perf events, when permitted) ----
+
+class CacheMissCounter {
+    int fd;
+
+public:
+    CacheMissCounter() : fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+        long long misses = -1;
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+                misses = -1;
+        }
+#endif
+        return misses;
+    }
+};
+
+// ---- Adapters giving every structure the same insert/find/erase/scan surface ----
+
+struct StdSetAdapter {
+    static const char* name() { return "std::set"; }
+    set<int> values;
+    void insert(int key) { values.insert(key); }
+    bool find(int key) { return values.find(key) != values.end(); }
+    void erase(int key) { values.erase(key); }
+    long long scan() {
+        long long sum = 0;
+        for (int key : values)
+            sum += key;
+        return sum;
+    }
+};
+
+struct SkipListAdapter {
+    static const char* name() { return "SkipList"; }
+    sl::SkipList list;
+    SkipListAdapter() : list(5, 0.5, 12345) {}
+    void insert(int key) { list.insert(key); }
+    bool find(int key) { return list.search(key); }
+    void erase(int key) { list.remove(key); }
+    long long scan() {
+        long long sum = 0;
+        for (int key : list)
+            sum += key;
+        return sum;
+    }
+};
+
+struct RBTreeAdapter {
+    static const char* name() { return "RBTree"; }
+    rbt::RBTree tree;
+    RBTreeAdapter() : tree(false) {}
+    void insert(int key) { tree.add(key); }
+    bool find(int key) { return tree.find(key); }
+    void erase(int key) { tree.Delete(key); }
+    long long scan() {
+        long long sum = 0;
+        tree.inorder([&sum](int key) { sum += key; });
+        return sum;
+    }
+};
+
+struct BPlusTreeAdapter {
+    static const char* name() { return "BPlusTree"; }
+    bpt::BPlusTree tree;
+    BPlusTreeAdapter() : tree(false) {}
+    void insert(int key) { tree.add(key); }
+    bool find(int key) { return tree.find(key); }
+    void erase(int key) { tree.Delete(key); }
+    long long scan() {
+        long long sum = 0;
+        tree.inorder([&sum](int key) { sum += key; });
+        return sum;
+    }
+};
+
+// ---- Measurement ----
+
+// Timed operations per phase: all of them in smaller phases, otherwise every
+// 2^k-th with k chosen to keep at least this many
+const long long TARGET_SAMPLES = 65536;
+// A percentile is only reported with at least this many samples above it
+const double MIN_TAIL_SAMPLES = 10;
+
+struct PhaseResult {
+    double mopsPerSecond;
+    double p50, p99, p999;  // Nanoseconds; NaN when there are too few samples
+    double missesPerOp;     // -1 when perf counters are unavailable
+};
+
+// Cost of one steady_clock::now() call, removed from per-operation timings
+double clockOverheadNs() {
+    static double overhead = -1;
+    if (overhead < 0) {
+        vector<double> gaps(10001);
+        for (double& gap : gaps) {
+            auto a = chrono::steady_clock::now();
+            auto b = chrono::steady_clock::now();
+            gap = chrono::duration<double, nano>(b - a).count();
+        }
+        nth_element(gaps.begin(), gaps.begin() + gaps.size() / 2, gaps.end());
+        overhead = gaps[gaps.size() / 2];
+    }
+    return overhead;
+}
+
+// Times ops(i) for i in [0, count). Small phases time every op on its own for
+// percentiles; larger ones time every stride-th op, at least TARGET_SAMPLES.
+template <typename Op>
+PhaseResult measure(long long count, CacheMissCounter& counter, Op op) {
+    long long stride = 1;
+    while (count / (stride * 2) >= TARGET_SAMPLES)
+        stride *= 2;
+    double overhead = clockOverheadNs();
+    vector<double> samples;
+    samples.reserve(count / stride + 1);
+
+    counter.start();
+    auto start = chrono::steady_clock::now();
+    for (long long i = 0; i < count; i++) {
+        if ((i & (stride - 1)) == 0) {
+            auto before = chrono::steady_clock::now();
+            op(i);
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - before).count() - overhead;
+            samples.push_back(ns > 0 ? ns : 0);
+        } else {
+            op(i);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    long long misses = counter.stop();
+    // Each timed op added two clock reads to the loop
+    seconds = max(seconds - samples.size() * 2 * overhead * 1e-9, seconds * 0.5);
+
+    PhaseResult result;
+    result.mopsPerSecond = count / seconds / 1e6;
+    result.missesPerOp = misses >= 0 ? double(misses) / count : -1;
+    sort(samples.begin(), samples.end());
+    auto pick = [&samples](double q) {
+        if (samples.size() * (1 - q) < MIN_TAIL_SAMPLES)
+            return numeric_limits<double>::quiet_NaN();
+        return samples[min(samples.size() - 1, size_t(q * samples.size()))];
+    };
+    result.p50 = pick(0.50);
+    result.p99 = pick(0.99);
+    result.p999 = pick(0.999);
+    return result;
+}
+
+void printRow(long long n, const char* structure, const string& workload, const PhaseResult& r) {
+    cout << setw(9) << n << setw(11) << structure << setw(15) << workload
+         << setw(10) << fixed << setprecision(2) << r.mopsPerSecond
+         << setprecision(0);
+    const double percentiles[] = {r.p50, r.p99, r.p999};
+    const int widths[] = {9, 9, 10};
+    for (int i = 0; i < 3; i++) {
+        if (isnan(percentiles[i]))
+            cout << setw(widths[i]) << "n/a";
+        else
+            cout << setw(widths[i]) << percentiles[i];
+    }
+    if (r.missesPerOp >= 0)
+        cout << setw(11) << setprecision(2) << r.missesPerOp;
+    else
+        cout << setw(11) << "n/a";
+    cout << endl;
+}
+
+struct Workload {
+    vector<int> randomKeys;  // Even keys 0, 2, ..., 2(n - 1), shuffled
+    vector<int> zipfProbes;  // Skewed picks among randomKeys
+    vector<int> uniformProbes;
+};
+
+template <typename Adapter>
+void runStructure(long long n, const Workload& w, CacheMissCounter& counter) {
+    const char* name = Adapter::name();
+
+    // Insert orders, each into a fresh structure
+    vector<int> sorted(w.randomKeys);
+    sort(sorted.begin(), sorted.end());
+    {
+        Adapter s;
+        printRow(n, name, "insert-sorted", measure(n, counter, [&](long long i) { s.insert(sorted[i]); }));
+    }
+    {
+        Adapter s;
+        printRow(n, name, "insert-reverse", measure(n, counter, [&](long long i) { s.insert(sorted[n - 1 - i]); }));
+    }
+
+    long long heapBefore = liveHeapBytes.load();
+    Adapter s;
+    printRow(n, name, "insert-random", measure(n, counter, [&](long long i) { s.insert(w.randomKeys[i]); }));
+    long long heapAfter = liveHeapBytes.load();
+
+    volatile long long sink = 0;
+    printRow(n, name, "lookup-uniform", measure(n, counter, [&](long long i) { sink += s.find(w.uniformProbes[i]); }));
+    printRow(n, name, "lookup-zipf", measure(n, counter, [&](long long i) { sink += s.find(w.zipfProbes[i]); }));
+
+    // Mixed read/write: writes alternately add a fresh odd key and drop the oldest one added
+    for (int readPercent : {95, 50}) {
+        deque<int> added;
+        int nextFresh = 1;
+        PhaseResult r = measure(n, counter, [&](long long i) {
+            if (int(i % 100) < readPercent) {
+                sink += s.find(w.zipfProbes[i]);
+            } else if (added.empty() || (i & 1)) {
+                s.insert(nextFresh);
+                added.push_back(nextFresh);
+                nextFresh += 2;
+            } else {
+                s.erase(added.front());
+                added.pop_front();
+            }
+        });
+        printRow(n, name, "mixed-" + to_string(readPercent) + "/" + to_string(100 - readPercent), r);
+        for (int key : added)
+            s.erase(key);
+    }
+
+    long long scans = max(1LL, 10000000LL / n);
+    PhaseResult scan = measure(scans, counter, [&](long long) { sink += s.scan(); });
+    // Report keys visited per second and per-key latency
+    scan.mopsPerSecond *= n;
+    scan.p50 /= n;
+    scan.p99 /= n;
+    scan.p999 /= n;
+    scan.missesPerOp = scan.missesPerOp >= 0 ? scan.missesPerOp / n : -1;
+    printRow(n, name, "scan (keys)", scan);
+
+    printRow(n, name, "delete-random", measure(n, counter, [&](long long i) { s.erase(w.uniformProbes[i]); }));
+
+    if (heapAccounting)
+        cout << setw(9) << n << setw(11) << name << setw(15) << "memory"
+             << setw(10) << fixed << setprecision(1) << double(heapAfter - heapBefore) / n << " bytes/element" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    vector<long long> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(atoll(argv[i]));
+    if (sizes.empty())
+        sizes = {1000, 10000, 100000, 1000000};
+
+    CacheMissCounter counter;
+    if (!counter.available())
+        cout << "Note: perf cache-miss counters unavailable, misses/op shows n/a" << endl;
+    cout << "Latency percentiles (ns) time every operation, or every 2^k-th once a phase has more than "
+         << TARGET_SAMPLES << "; n/a marks a percentile with fewer than " << MIN_TAIL_SAMPLES
+         << " samples above it." << endl;
+
+    cout << setw(9) << "n" << setw(11) << "structure" << setw(15) << "workload"
+         << setw(10) << "Mops/s" << setw(9) << "p50" << setw(9) << "p99" << setw(10) << "p99.9"
+         << setw(11) << "misses/op" << endl;
+
+    for (long long n : sizes) {
+        Workload w;
+        mt19937_64 rng(2024);
+        w.randomKeys.resize(n);
+        for (long long i = 0; i < n; i++)
+            w.randomKeys[i] = int(2 * i);
+        shuffle(w.randomKeys.begin(), w.randomKeys.end(), rng);
+
+        // Zipf ranks map onto the shuffled keys, so hot keys are spread over the key space
+        ZipfGenerator zipf(n);
+        w.zipfProbes.resize(n);
+        w.uniformProbes = w.randomKeys;
+        shuffle(w.uniformProbes.begin(), w.uniformProbes.end(), rng);
+        for (long long i = 0; i < n; i++)
+            w.zipfProbes[i] = w.randomKeys[zipf.next(rng)];
+
+        runStructure<StdSetAdapter>(n, w, counter);
+        runStructure<SkipListAdapter>(n, w, counter);
+        runStructure<RBTreeAdapter>(n, w, counter);
+        runStructure<BPlusTreeAdapter>(n, w, counter);
+    }
+
+    return 0;
+}
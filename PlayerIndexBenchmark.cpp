@@ -0,0 +1,196 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <streambuf>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+#define PLAYERS_NO_MAIN
+#include "PlayersProbUsingSkipList.cpp"
+#define BENCHMARK_HEAP_ACCOUNTING
+#include "BenchmarkUtil.h"
+
+// Compares the flat PlayerIndex in PlayersProbUsingSkipList.cpp with the
+// std::unordered_map<int, Node *> it replaced: heap bytes per player for the
+// index alone, and displayPlayerScore / getScore / updateScore throughput of
+// the whole leaderboard built on each.
+// Usage: ./PlayerIndexBenchmark [n1 n2 ...]   (default sizes 100000 1000000)
+
+// The previous index, behind the same interface as PlayerIndex
+class UnorderedPlayerIndex
+{
+    unordered_map<int, Node *> map;
+
+public:
+    typedef Node NodeType;
+
+    Node *find(int playerId) const
+    {
+        auto it = map.find(playerId);
+        return it == map.end() ? nullptr : it->second;
+    }
+
+    Node **findOrInsert(int playerId, bool &inserted)
+    {
+        auto result = map.emplace(playerId, nullptr);
+        inserted = result.second;
+        return &result.first->second;
+    }
+
+    void commitInsert() {}
+
+    Node *erase(int playerId)
+    {
+        auto it = map.find(playerId);
+        if (it == map.end())
+        {
+            return nullptr;
+        }
+        Node *node = it->second;
+        map.erase(it);
+        return node;
+    }
+
+    void reserve(size_t players) { map.reserve(players); }
+    void clear() { map.clear(); }
+    size_t size() const { return map.size(); }
+};
+
+// Swallows displayPlayerScore output so the benchmark measures the call, not the terminal
+class NullBuffer : public streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char *, streamsize count) override { return count; }
+};
+
+// Distinct player IDs spread over the whole positive range like real account
+// IDs, rather than 0..n-1 (an odd multiplier is a bijection modulo 2^31)
+vector<int> makePlayerIds(int players)
+{
+    vector<int> ids(players);
+    for (int i = 0; i < players; i++)
+    {
+        ids[i] = int((uint32_t(i + 1) * 2246822519u) & 0x7fffffffu);
+    }
+    return ids;
+}
+
+template <typename Index>
+double indexBytesPerPlayer(const vector<int> &ids)
+{
+    long long before = liveHeapBytes;
+    Index index;
+    bool inserted;
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        Node **slot = index.findOrInsert(ids[i], inserted);
+        if (inserted)
+        {
+            *slot = reinterpret_cast<Node *>(uintptr_t(i + 1) * 64); // Never dereferenced
+            index.commitInsert();
+        }
+    }
+    return double(liveHeapBytes - before) / index.size();
+}
+
+struct Throughput
+{
+    double displayMops, lookupMops, updateMops;
+};
+
+template <typename Index>
+Throughput measureBoard(const vector<int> &ids, int operations)
+{
+    BasicSkipList<Index> board(24, 0.5, false);
+    uint64_t rng = 7;
+    for (int id : ids)
+    {
+        board.addPlayer(id, int(nextRandom(rng) % 1000000));
+    }
+
+    vector<int> targets(operations);
+    for (int &target : targets)
+    {
+        target = ids[nextRandom(rng) % ids.size()];
+    }
+    Throughput result;
+
+    NullBuffer discard;
+    streambuf *original = cout.rdbuf(&discard);
+    auto start = chrono::steady_clock::now();
+    for (int target : targets)
+    {
+        board.displayPlayerScore(target);
+    }
+    result.displayMops = operations / chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(original);
+
+    long long checksum = 0;
+    start = chrono::steady_clock::now();
+    for (int target : targets)
+    {
+        int score;
+        if (board.getScore(target, score))
+        {
+            checksum += score;
+        }
+    }
+    result.lookupMops = operations / chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    // Small score changes, the common case for live games
+    start = chrono::steady_clock::now();
+    for (int target : targets)
+    {
+        int score = 0;
+        board.getScore(target, score);
+        board.updateScore(target, score + int(nextRandom(rng) % 21) - 10);
+    }
+    result.updateMops = operations / chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    if (checksum == 42)
+    {
+        cout << ""; // Keep the lookups from being optimised away
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+    {
+        sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty())
+    {
+        sizes = {100000, 1000000};
+    }
+
+    cout << setw(10) << "players" << setw(16) << "index" << setw(14) << "bytes/player" << setw(14)
+         << "display M/s" << setw(14) << "getScore M/s" << setw(14) << "update M/s" << endl;
+    for (int players : sizes)
+    {
+        vector<int> ids = makePlayerIds(players);
+        int operations = 1000000;
+
+        Throughput flat = measureBoard<PlayerIndex>(ids, operations);
+        Throughput unordered = measureBoard<UnorderedPlayerIndex>(ids, operations);
+        double flatBytes = indexBytesPerPlayer<PlayerIndex>(ids);
+        double unorderedBytes = indexBytesPerPlayer<UnorderedPlayerIndex>(ids);
+
+        cout << fixed << setprecision(2);
+        cout << setw(10) << players << setw(16) << "PlayerIndex" << setw(14);
+        heapAccounting ? cout << flatBytes : cout << "n/a";
+        cout << setw(14) << flat.displayMops << setw(14) << flat.lookupMops << setw(14) << flat.updateMops << endl;
+        cout << setw(10) << players << setw(16) << "unordered_map" << setw(14);
+        heapAccounting ? cout << unorderedBytes : cout << "n/a";
+        cout << setw(14) << unordered.displayMops << setw(14) << unordered.lookupMops << setw(14)
+             << unordered.updateMops << endl;
+    }
+
+    return 0;
+}
@@ -3,157 +3,773 @@
 #include <ctime>
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <cmath>
+#include <new>
 #include <algorithm>
 using namespace std;
 
-struct Node
+const int MAX_LEVEL = 32; // Upper bound on tower height, sizes the on-stack update arrays
+
+// A player's node. The forward tower and the link spans are stored inline
+// after the fixed fields: a node of level L is allocated with room for L + 1
+// pointers followed by L + 1 spans, so each node is one allocation and a hop
+// reads the score, ID and next pointer from the same cache line. Score is int
+// for the usual boards; DecayingBoard in WindowedLeaderboard.cpp uses long long.
+template <typename Score>
+struct BasicNode
 {
+    typedef Score ScoreType;
+
     int playerId;
-    int score;
-    vector<Node *> forward; // Forward pointers at different levels
+    int level; // Highest level this node is linked on
+    Score score;
+    BasicNode *backward;   // Previous node on level 0 (nullptr for the first player)
+    BasicNode *forward[1]; // Forward pointers at different levels (really level + 1 entries)
+
+    // span()[i]: players skipped by forward[i]; for a null link, players after this node
+    int *span() { return reinterpret_cast<int *>(forward + level + 1); }
+    const int *span() const { return reinterpret_cast<const int *>(forward + level + 1); }
+
+    static size_t bytesFor(int level)
+    {
+        size_t bytes = offsetof(BasicNode, forward) + (level + 1) * (sizeof(BasicNode *) + sizeof(int));
+        return (bytes + alignof(BasicNode) - 1) & ~(alignof(BasicNode) - 1);
+    }
+
+    static BasicNode *create(int id, Score sc, int level)
+    {
+        BasicNode *node = static_cast<BasicNode *>(operator new(bytesFor(level)));
+        node->playerId = id;
+        node->level = level;
+        node->score = sc;
+        node->backward = nullptr;
+        for (int i = 0; i <= level; i++)
+        {
+            node->forward[i] = nullptr;
+            node->span()[i] = 0;
+        }
+        return node;
+    }
+
+    static void destroy(BasicNode *node)
+    {
+        operator delete(node);
+    }
+};
+
+typedef BasicNode<int> Node;
+
+// One row of a leaderboard query; rank is 1-based
+template <typename Score>
+struct BasicLeaderboardEntry
+{
+    int playerId;
+    Score score;
+    int rank;
+};
+
+typedef BasicLeaderboardEntry<int> LeaderboardEntry;
+
+// Saturate a 64-bit score computation to the int range the board stores
+int clampScore(long long value)
+{
+    return value > INT_MAX ? INT_MAX : value < INT_MIN ? INT_MIN : int(value);
+}
+
+// Flat open-addressing map from playerId to its node: linear probing over a
+// power-of-two table, with the multiplication method from Hashing.cpp done in
+// integers (A = 0.618... scaled to 2^32, keeping the top bits). A single probe
+// sequence answers each call, and erase shifts the following entries back
+// instead of leaving tombstones, so lookups never slow down after churn.
+template <typename NodeT>
+class BasicPlayerIndex
+{
+public:
+    typedef NodeT NodeType;
+
+private:
+    typedef NodeT Node;
+
+    struct Slot
+    {
+        int playerId;
+        Node *node; // nullptr marks an empty slot
+    };
+
+    vector<Slot> slots;
+    size_t count;
+    size_t mask;
+    int shift; // 32 - log2(slots.size())
+
+    size_t home(int playerId) const
+    {
+        return (uint32_t(playerId) * 2654435769u) >> shift;
+    }
+
+    void rehash(size_t capacity)
+    {
+        vector<Slot> old(capacity, Slot{0, nullptr});
+        old.swap(slots);
+        mask = capacity - 1;
+        shift = 32;
+        while ((size_t(1) << (32 - shift)) < capacity)
+        {
+            shift--;
+        }
+
+        for (const Slot &slot : old)
+        {
+            if (slot.node)
+            {
+                size_t i = home(slot.playerId);
+                while (slots[i].node)
+                {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = slot;
+            }
+        }
+    }
+
+public:
+    BasicPlayerIndex() : count(0)
+    {
+        rehash(16);
+    }
+
+    // Node of the player, or nullptr if absent
+    Node *find(int playerId) const
+    {
+        for (size_t i = home(playerId);; i = (i + 1) & mask)
+        {
+            const Slot &slot = slots[i];
+            if (!slot.node || slot.playerId == playerId)
+            {
+                return slot.node;
+            }
+        }
+    }
+
+    // Slot holding the player's node. When the player is new, inserted is set
+    // and the slot is still empty: the caller stores a non-null node there and
+    // then calls commitInsert, both before the next call. Until then nothing
+    // has changed, so a caller that fails to build the node can just give up.
+    Node **findOrInsert(int playerId, bool &inserted)
+    {
+        size_t i = home(playerId);
+        while (slots[i].node && slots[i].playerId != playerId)
+        {
+            i = (i + 1) & mask;
+        }
+        inserted = !slots[i].node;
+        if (inserted && (count + 1) * 4 > slots.size() * 3) // Keep the load factor at most 3/4
+        {
+            rehash(slots.size() * 2);
+            for (i = home(playerId); slots[i].node; i = (i + 1) & mask)
+            {
+            }
+        }
+        slots[i].playerId = playerId;
+        return &slots[i].node;
+    }
+
+    // Count the node just stored in the slot returned by findOrInsert
+    void commitInsert()
+    {
+        count++;
+    }
+
+    // Remove the player and return its node, or nullptr if absent
+    Node *erase(int playerId)
+    {
+        size_t i = home(playerId);
+        while (slots[i].node && slots[i].playerId != playerId)
+        {
+            i = (i + 1) & mask;
+        }
+        Node *node = slots[i].node;
+        if (!node)
+        {
+            return nullptr;
+        }
+
+        // Backward-shift deletion: pull later entries of the run into the hole
+        // unless that would move them in front of their home slot
+        for (size_t j = (i + 1) & mask; slots[j].node; j = (j + 1) & mask)
+        {
+            if (((j - home(slots[j].playerId)) & mask) >= ((j - i) & mask))
+            {
+                slots[i] = slots[j];
+                i = j;
+            }
+        }
+        slots[i].node = nullptr;
+        count--;
+        return node;
+    }
 
-    Node(int id, int sc, int level) : playerId(id), score(sc), forward(level + 1, nullptr) {}
+    void reserve(size_t players)
+    {
+        size_t capacity = slots.size();
+        while (players * 4 > capacity * 3)
+        {
+            capacity *= 2;
+        }
+        if (capacity != slots.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    void clear()
+    {
+        count = 0;
+        vector<Slot>(16, Slot{0, nullptr}).swap(slots);
+        rehash(16);
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    size_t memoryBytes() const
+    {
+        return slots.capacity() * sizeof(Slot);
+    }
 };
 
-// Skip List class
-class SkipList
+typedef BasicPlayerIndex<Node> PlayerIndex;
+
+// Skip list ordered by score, parameterised on the playerId index so that
+// the benchmark can swap in other maps; SkipList below is the one to use.
+// The node type, and with it the score type, comes from Index::NodeType.
+template <typename Index>
+class BasicSkipList
 {
-    int maxLevel;
+public:
+    typedef typename Index::NodeType Node;
+    typedef typename Node::ScoreType Score;
+    typedef BasicLeaderboardEntry<Score> Entry;
+
+private:
+    int maxLevel; // Tallest tower a new node may get, grows with the number of players
     float probability;
-    Node *header;
+    Node *header; // Tall enough for MAX_LEVEL, so maxLevel can grow without reallocating it
     int level;
+    int length; // Number of players in the list
+    bool verbose; // Print a line for every score update
+    double nextGrowth; // Player count at which maxLevel is raised again: (1/p)^maxLevel
+    uint64_t rngState; // Per-instance xorshift64* state
+    int bitsPerLevel;  // k when probability == 1/2^k (levels come from trailing zeros), else 0
+
+    Index playerIndex; // Finds a player's node by ID
+
+    uint64_t nextRandom()
+    {
+        rngState ^= rngState >> 12;
+        rngState ^= rngState << 25;
+        rngState ^= rngState >> 27;
+        return rngState * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Keep maxLevel near log_{1/p}(length) so rank queries stay logarithmic
+    void growMaxLevel()
+    {
+        while (length >= nextGrowth && maxLevel < MAX_LEVEL)
+        {
+            maxLevel++;
+            nextGrowth /= probability;
+        }
+    }
+
+    // Leaderboard order: higher score first, ties broken by lower playerId.
+    // The pair is unique per player, so every node has one exact position.
+    static bool ranksBefore(Score scoreA, int idA, Score scoreB, int idB)
+    {
+        return scoreA > scoreB || (scoreA == scoreB && idA < idB);
+    }
+
+    // Collect the last node ranked before (score, playerId) on every level,
+    // along with that node's rank (header = 0)
+    void findPredecessors(Score score, int playerId, Node **update, int *rank)
+    {
+        Node *current = header;
+        int traversed = 0;
+        for (int i = level; i >= 0; i--)
+        {
+            while (current->forward[i] &&
+                   ranksBefore(current->forward[i]->score, current->forward[i]->playerId, score, playerId))
+            {
+                traversed += current->span()[i];
+                current = current->forward[i];
+            }
+            update[i] = current;
+            rank[i] = traversed;
+        }
+    }
+
+    // Node holding the given 1-based rank, or nullptr if out of range
+    const Node *nodeAtRank(int rank) const
+    {
+        if (rank < 1 || rank > length)
+        {
+            return nullptr;
+        }
+
+        const Node *current = header;
+        int traversed = 0;
+        for (int i = level; i >= 0; i--)
+        {
+            while (current->forward[i] && traversed + current->span()[i] <= rank)
+            {
+                traversed += current->span()[i];
+                current = current->forward[i];
+            }
+            if (traversed == rank)
+            {
+                return current;
+            }
+        }
+        return nullptr;
+    }
+
+    // Walk level 0 from the given rank and collect up to limit entries
+    vector<Entry> collectFrom(int rank, int limit) const
+    {
+        vector<Entry> entries;
+        if (limit <= 0)
+        {
+            return entries;
+        }
+
+        const Node *current = nodeAtRank(rank);
+        while (current && (int)entries.size() < limit)
+        {
+            entries.push_back({current->playerId, current->score, rank++});
+            current = current->forward[0];
+        }
+        return entries;
+    }
+
+    // Splice node in at the position for its current score, reusing its tower
+    void link(Node *node)
+    {
+        Node *update[MAX_LEVEL + 1];
+        int rank[MAX_LEVEL + 1];
+        findPredecessors(node->score, node->playerId, update, rank);
 
-    unordered_map<int, Node *> playerMap; // Map to track players by ID
+        int nodeLevel = node->level;
+        if (nodeLevel > level)
+        {
+            for (int i = level + 1; i <= nodeLevel; i++)
+            {
+                update[i] = header; // Point the header node to new level
+                rank[i] = 0;
+                header->span()[i] = length;
+            }
+            level = nodeLevel; // Increase the list's level
+        }
+
+        for (int i = 0; i <= nodeLevel; i++)
+        {
+            node->forward[i] = update[i]->forward[i];
+            update[i]->forward[i] = node;
+
+            // Split the predecessor's span at the new node
+            node->span()[i] = update[i]->span()[i] - (rank[0] - rank[i]);
+            update[i]->span()[i] = rank[0] - rank[i] + 1;
+        }
+
+        // Links above the node's tower now skip one more player
+        for (int i = nodeLevel + 1; i <= level; i++)
+        {
+            update[i]->span()[i]++;
+        }
+        length++;
+        growMaxLevel();
+
+        node->backward = (update[0] == header) ? nullptr : update[0];
+        if (node->forward[0])
+        {
+            node->forward[0]->backward = node;
+        }
+    }
+
+    // Take node out of every level with one descent on its (score, playerId) key
+    void unlink(Node *node)
+    {
+        Node *update[MAX_LEVEL + 1];
+        int rank[MAX_LEVEL + 1];
+        findPredecessors(node->score, node->playerId, update, rank);
+
+        for (int i = 0; i <= level; i++)
+        {
+            if (update[i]->forward[i] == node)
+            {
+                update[i]->span()[i] += node->span()[i] - 1;
+                update[i]->forward[i] = node->forward[i]; // Remove node from forward pointers
+            }
+            else
+            {
+                update[i]->span()[i]--;
+            }
+        }
+        length--;
+        if (node->forward[0])
+        {
+            node->forward[0]->backward = node->backward;
+        }
+
+        // Reduce the level of the skip list if necessary
+        while (level > 0 && header->forward[level] == nullptr)
+        {
+            level--;
+        }
+    }
 
 public:
-    SkipList(int maxLvl, float prob) : maxLevel(maxLvl), probability(prob), level(0)
+    // maxLvl is only the starting height: it rises by one each time the board
+    // passes (1/p)^maxLevel players, up to MAX_LEVEL. A seed of 0 draws one
+    // from rand(), so srand() still controls the layout; pass a fixed seed for
+    // reproducible boards.
+    BasicSkipList(int maxLvl, float prob, bool verbose = true, uint64_t seed = 0)
+        : maxLevel(max(0, min(maxLvl, MAX_LEVEL))), probability(prob), level(0), length(0), verbose(verbose),
+          bitsPerLevel(0)
     {
-        header = new Node(-1, -1, maxLevel); // create header node with no ID or score
+        nextGrowth = pow(1.0 / probability, maxLevel);
+        header = Node::create(-1, -1, MAX_LEVEL); // create header node with no ID or score
+
+        if (seed == 0)
+        {
+            seed = (uint64_t(rand()) << 32) ^ uint64_t(rand()) ^ 0x9E3779B97F4A7C15ULL;
+        }
+        rngState = seed;
+
+        for (int k = 1; k <= 8; k++)
+        {
+            if (fabs(probability - ldexp(1.0, -k)) < 1e-7)
+            {
+                bitsPerLevel = k;
+                break;
+            }
+        }
     }
 
-    ~SkipList()
+    ~BasicSkipList()
     {
         Node *current = header;
         while (current)
         {
             Node *temp = current;
             current = current->forward[0];
-            delete temp;
+            Node::destroy(temp);
         }
     }
 
+    BasicSkipList(const BasicSkipList &) = delete;
+    BasicSkipList &operator=(const BasicSkipList &) = delete;
+
     int randomLevel()
     {
         int lvl = 0;
-        while ((rand() / double(RAND_MAX)) < probability && lvl < maxLevel)
+        if (bitsPerLevel > 0)
+        {
+            // Each run of bitsPerLevel zero bits is one success with probability 1/2^k
+            uint64_t bits = nextRandom() | (1ULL << 63);
+            lvl = __builtin_ctzll(bits) / bitsPerLevel;
+            return lvl < maxLevel ? lvl : maxLevel;
+        }
+        while ((nextRandom() >> 11) * 0x1.0p-53 < probability && lvl < maxLevel)
         {
             lvl++;
         }
         return lvl;
     }
 
-    void addPlayer(int playerId, int initialScore)
+    void addPlayer(int playerId, Score initialScore)
     {
-        if (playerMap.find(playerId) != playerMap.end())
+        bool inserted;
+        Node **slot = playerIndex.findOrInsert(playerId, inserted);
+        if (!inserted)
         {
             cout << "Player with ID " << playerId << " already exists!" << endl;
             return;
         }
 
-        vector<Node *> update(maxLevel + 1, nullptr);
-        Node *current = header;
+        Node *newNode = Node::create(playerId, initialScore, randomLevel());
+        link(newNode);
+        *slot = newNode; // Add player to index
+        playerIndex.commitInsert();
+    }
 
-        // Find the correct position to insert the new player by descending order
-        for (int i = level; i >= 0; i--)
+    void removePlayer(int playerId)
+    {
+        Node *targetNode = playerIndex.erase(playerId);
+        if (!targetNode)
         {
-            while (current->forward[i] && current->forward[i]->score > initialScore)
-            {
-                current = current->forward[i];
-            }
-            update[i] = current;
+            cout << "Player with ID " << playerId << " does not exist!" << endl;
+            return;
         }
 
-        int randomLvl = randomLevel();
-        if (randomLvl > level)
+        unlink(targetNode);
+        Node::destroy(targetNode);
+    }
+
+    // Move a player to a new score without reallocating its node. When the new
+    // score still ranks between the player's neighbours nothing is relinked.
+    void updateScore(int playerId, Score newScore)
+    {
+        Node *node = playerIndex.find(playerId);
+        if (!node)
         {
-            for (int i = level + 1; i <= randomLvl; i++)
-            {
-                update[i] = header; // Point the header node to new level
-            }
-            level = randomLvl; // Increase the list's level
+            cout << "Player with ID " << playerId << " does not exist!" << endl;
+            return;
         }
 
-        Node *newNode = new Node(playerId, initialScore, randomLvl);
-        for (int i = 0; i <= randomLvl; i++)
+        Score oldScore = node->score;
+        Node *prev = node->backward;
+        Node *next = node->forward[0];
+
+        bool staysInPlace = (prev == nullptr || ranksBefore(prev->score, prev->playerId, newScore, playerId)) &&
+                            (next == nullptr || ranksBefore(newScore, playerId, next->score, next->playerId));
+        if (staysInPlace)
+        {
+            node->score = newScore;
+        }
+        else
         {
-            newNode->forward[i] = update[i]->forward[i];
-            update[i]->forward[i] = newNode;
+            unlink(node);
+            node->score = newScore;
+            link(node);
         }
 
-        playerMap[playerId] = newNode; // Add player to map
+        if (verbose)
+        {
+            cout << "Updated player " << playerId << "'s score from " << oldScore << " to " << newScore << endl;
+        }
     }
 
-    void removePlayer(int playerId)
+    int size() const
+    {
+        return length;
+    }
+
+    // Look up a player's score without printing; returns false if absent
+    bool getScore(int playerId, Score &score) const
     {
-        if (playerMap.find(playerId) == playerMap.end())
+        Node *node = playerIndex.find(playerId);
+        if (!node)
         {
-            cout << "Player with ID " << playerId << " does not exist!" << endl;
-            return;
+            return false;
         }
+        score = node->score;
+        return true;
+    }
 
-        vector<Node *> update(maxLevel + 1, nullptr);
-        Node *current = header;
+    // Fill an empty board from records already in leaderboard order (each with
+    // playerId and score members) in linear time: every node is appended
+    // behind the last node of each level it reaches, so no descent is needed.
+    // Stops and returns false at the first record that is out of order or
+    // repeats a playerId.
+    template <typename Iterator>
+    bool loadSorted(Iterator first, Iterator last)
+    {
+        if (length != 0)
+        {
+            cout << "loadSorted needs an empty leaderboard!" << endl;
+            return false;
+        }
+        playerIndex.reserve(distance(first, last));
 
-        // Traverse the list to find the node to remove
-        for (int i = level; i >= 0; i--)
+        vector<Node *> tail(MAX_LEVEL + 1, header); // Last node on each level so far
+        vector<int> tailRank(MAX_LEVEL + 1, 0);
+        bool ok = true;
+        for (; first != last; ++first)
         {
-            while (current->forward[i] && current->forward[i]->playerId != playerId)
+            int playerId = first->playerId;
+            Score score = first->score;
+            if (tail[0] != header && !ranksBefore(tail[0]->score, tail[0]->playerId, score, playerId))
             {
-                current = current->forward[i];
+                ok = false;
+                break;
             }
-            update[i] = current;
+            bool inserted;
+            Node **slot = playerIndex.findOrInsert(playerId, inserted);
+            if (!inserted)
+            {
+                ok = false;
+                break;
+            }
+
+            Node *node = Node::create(playerId, score, randomLevel());
+            int nodeLevel = node->level;
+            int rank = length + 1;
+            node->backward = (tail[0] == header) ? nullptr : tail[0];
+            for (int i = 0; i <= nodeLevel; i++)
+            {
+                tail[i]->forward[i] = node;
+                tail[i]->span()[i] = rank - tailRank[i];
+                tail[i] = node;
+                tailRank[i] = rank;
+            }
+            level = max(level, nodeLevel);
+            length = rank;
+            growMaxLevel();
+            *slot = node;
+            playerIndex.commitInsert();
         }
 
-        Node *targetNode = playerMap[playerId];
+        // Links that end the list span the players behind them
         for (int i = 0; i <= level; i++)
         {
-            if (update[i]->forward[i] == targetNode)
+            tail[i]->span()[i] = length - tailRank[i];
+        }
+        return ok;
+    }
+
+    // Remove every player for which remove(playerId, score) is true in one pass
+    // over level 0, relinking and recounting spans as it goes, instead of one
+    // descent per removed player. Returns the number of players removed.
+    template <typename Predicate>
+    int removeIf(Predicate remove)
+    {
+        vector<Node *> last(level + 1, header); // Last kept node on each level
+        vector<int> lastRank(level + 1, 0);
+        int kept = 0;
+        int removed = 0;
+
+        Node *current = header->forward[0];
+        while (current)
+        {
+            Node *next = current->forward[0];
+            int nodeLevel = current->level;
+            if (remove(current->playerId, current->score))
             {
-                update[i]->forward[i] = targetNode->forward[i]; // Remove node from forward pointers
+                for (int i = 0; i <= nodeLevel; i++)
+                {
+                    last[i]->forward[i] = current->forward[i];
+                }
+                playerIndex.erase(current->playerId);
+                Node::destroy(current);
+                removed++;
             }
+            else
+            {
+                kept++;
+                current->backward = (last[0] == header) ? nullptr : last[0];
+                for (int i = 0; i <= nodeLevel; i++)
+                {
+                    last[i]->span()[i] = kept - lastRank[i];
+                    last[i] = current;
+                    lastRank[i] = kept;
+                }
+            }
+            current = next;
         }
 
-        delete targetNode;
-        playerMap.erase(playerId);
-
-        // Reduce the level of the skip list if necessary
+        length = kept;
+        for (int i = 0; i <= level; i++)
+        {
+            last[i]->span()[i] = length - lastRank[i];
+        }
         while (level > 0 && header->forward[level] == nullptr)
         {
             level--;
         }
+        return removed;
     }
 
-    void updateScore(int playerId, int newScore)
+    // Drop every player at once, keeping the header for reuse
+    void clear()
     {
-        if (playerMap.find(playerId) == playerMap.end())
+        Node *current = header->forward[0];
+        while (current)
         {
-            cout << "Player with ID " << playerId << " does not exist!" << endl;
-            return;
+            Node *temp = current;
+            current = current->forward[0];
+            Node::destroy(temp);
         }
+        for (int i = 0; i <= MAX_LEVEL; i++)
+        {
+            header->forward[i] = nullptr;
+            header->span()[i] = 0;
+        }
+        playerIndex.clear();
+        level = 0;
+        length = 0;
+    }
+
+    // Visit every player in leaderboard order as visit(playerId, score)
+    template <typename Visitor>
+    void forEachPlayer(Visitor visit) const
+    {
+        for (const Node *current = header->forward[0]; current; current = current->forward[0])
+        {
+            visit(current->playerId, current->score);
+        }
+    }
+
+    // 1-based position of the player on the leaderboard, or -1 if absent
+    int getRank(int playerId) const
+    {
+        const Node *target = playerIndex.find(playerId);
+        if (!target)
+        {
+            return -1;
+        }
+
+        const Node *current = header;
+        int traversed = 0;
+        for (int i = level; i >= 0; i--)
+        {
+            // Advance over everything ranked before the target, then onto the target itself
+            while (current->forward[i] &&
+                   !ranksBefore(target->score, target->playerId, current->forward[i]->score, current->forward[i]->playerId))
+            {
+                traversed += current->span()[i];
+                current = current->forward[i];
+            }
+            if (current == target)
+            {
+                return traversed;
+            }
+        }
+        return -1;
+    }
 
-        int oldScore = playerMap[playerId]->score;
-        removePlayer(playerId);
-        addPlayer(playerId, newScore);
+    // The player plus up to k neighbours on each side; empty if the player is absent
+    vector<Entry> getAround(int playerId, int k) const
+    {
+        int rank = getRank(playerId);
+        if (rank < 0 || k < 0)
+        {
+            return {};
+        }
+        // rank + k can pass INT_MAX, so the window is clipped to the board in long long
+        int first = max(1, rank - k);
+        int last = int(min<long long>((long long)rank + k, length));
+        return collectFrom(first, last - first + 1);
+    }
 
-        cout << "Updated player " << playerId << "'s score from " << oldScore << " to " << newScore << endl;
+    // Up to limit players starting after the first offset players
+    vector<Entry> getPage(int offset, int limit) const
+    {
+        if (offset < 0 || offset >= length)
+        {
+            return {};
+        }
+        return collectFrom(offset + 1, limit);
     }
 
-    void displayLeaderboard(int topN)
+    void displayLeaderboard(int topN) const
     {
         cout << "Top " << topN << " players:" << endl;
 
-        Node *current = header->forward[0]; // Start from the head of the list
+        const Node *current = header->forward[0]; // Start from the head of the list
 
         int count = 0;
         while (current && count < topN)
@@ -164,11 +780,12 @@ public:
         }
     }
 
-    void displayPlayerScore(int playerId)
+    void displayPlayerScore(int playerId) const
     {
-        if (playerMap.find(playerId) != playerMap.end())
+        Node *node = playerIndex.find(playerId);
+        if (node)
         {
-            cout << "Player ID " << playerId << "'s score: " << playerMap[playerId]->score << endl;
+            cout << "Player ID " << playerId << "'s score: " << node->score << endl;
         }
         else
         {
@@ -176,11 +793,11 @@ public:
         }
     }
 
-    void printPlayersScores()
+    void printPlayersScores() const
     {
         for (int i = level; i >= 0; i--)
         {
-            Node *current = header->forward[i];
+            const Node *current = header->forward[i];
             cout << "Level " << i << ": " << endl;
             while (current)
             {
@@ -192,6 +809,10 @@ public:
     }
 };
 
+typedef BasicSkipList<PlayerIndex> SkipList;
+
+// Define PLAYERS_NO_MAIN to include this file from another program
+#ifndef PLAYERS_NO_MAIN
 int main()
 {
     srand(time(0));
@@ -218,5 +839,23 @@ int main()
     leaderboard.displayLeaderboard(3);
     leaderboard.printPlayersScores();
 
+    // Rank lookups and paging use the link spans instead of walking the list
+    leaderboard.addPlayer(5, 60);
+    leaderboard.addPlayer(6, 10);
+    cout << "Player 1 is ranked " << leaderboard.getRank(1) << " of " << leaderboard.size() << endl;
+
+    cout << "Around player 1:" << endl;
+    for (const LeaderboardEntry &entry : leaderboard.getAround(1, 1))
+    {
+        cout << "#" << entry.rank << " ID: " << entry.playerId << " (Score: " << entry.score << ")" << endl;
+    }
+
+    cout << "Page 2 (2 per page):" << endl;
+    for (const LeaderboardEntry &entry : leaderboard.getPage(2, 2))
+    {
+        cout << "#" << entry.rank << " ID: " << entry.playerId << " (Score: " << entry.score << ")" << endl;
+    }
+
     return 0;
 }
+#endif // PLAYERS_NO_MAIN
@@ -1,10 +1,22 @@
 #include <iostream>
 #include <queue>
 #include <limits>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RBT_HAVE_MMAP 1
+#endif
+#include "RBTreeCore.h"
 using namespace std;
 
-enum NodeColor { RED, BLACK };
-
 struct Node {
     int key;
     NodeColor color;
@@ -17,207 +29,27 @@ struct Node {
     }
 };
 
-class RBTree {
-private:
-    Node* root;
+// On-disk layout written by RBTree::save: this header followed by `count`
+// int32 keys in ascending order (host byte order). Colors are not stored;
+// load() rebuilds a balanced tree and derives a valid coloring in O(n).
+struct RBTreeFileHeader {
+    char magic[4];     // "RBT1"
+    uint32_t keyBytes; // sizeof(int) of the writer
+    uint64_t count;
+};
 
+class RBTree : public RBTreeCore<Node> {
+private:
+    bool verbose; // Print progress and the tree after every add/Delete
 
-    Node* insertToBST(Node* root, Node* newNode) {
+    template <typename Visitor>
+    void inorderVisit(Node* root, Visitor& visit) {
         if (root == nullptr)
-            return newNode;
-
-        if (newNode->key < root->key) {
-            root->left = insertToBST(root->left, newNode);
-            if (root->left != nullptr) root->left->parent = root;
-        } else if (newNode->key > root->key) {
-            root->right = insertToBST(root->right, newNode);
-            if (root->right != nullptr) root->right->parent = root;
-        }
-
-        return root;
-    }
-
-
-    void rotateLeft(Node*& root, Node*& node) {
-        Node* rightChild = node->right;
-
-        node->right = rightChild->left;
-        if (node->right != nullptr)
-            node->right->parent = node;
-
-        rightChild->parent = node->parent;
-        if (node->parent == nullptr)
-            root = rightChild;
-        else if (node == node->parent->left)
-            node->parent->left = rightChild;
-        else
-            node->parent->right = rightChild;
-
-        rightChild->left = node;
-        node->parent = rightChild;
-    }
-
-    void rotateRight(Node*& root, Node*& node) {
-        Node* leftChild = node->left;
-
-        node->left = leftChild->right;
-        if (node->left != nullptr)
-            node->left->parent = node;
-
-        leftChild->parent = node->parent;
-        if (node->parent == nullptr)
-            root = leftChild;
-        else if (node == node->parent->left)
-            node->parent->left = leftChild;
-        else
-            node->parent->right = leftChild;
-
-        leftChild->right = node;
-        node->parent = leftChild;
-    }
-
-
-    void resolveInsert(Node*& root, Node*& node) {
-        Node* parent = nullptr;
-        Node* grandParent = nullptr;
-
-        while ((node != root) && (node->color == RED) && (node->parent->color == RED)) {
-            parent = node->parent;
-            grandParent = node->parent->parent;
-
-            if (parent == grandParent->left) {
-                Node* uncle = grandParent->right;
-
-                if (uncle != nullptr && uncle->color == RED) {
-                    grandParent->color = RED;
-                    parent->color = BLACK;
-                    uncle->color = BLACK;
-                    node = grandParent;
-                } else {
-                    if (node == parent->right) {
-                        rotateLeft(root, parent);
-                        node = parent;
-                        parent = node->parent;
-                    }
-
-                    rotateRight(root, grandParent);
-                    swap(parent->color, grandParent->color);
-                    node = parent;
-                }
-            } else {
-                Node* uncle = grandParent->left;
-
-                if (uncle != nullptr && uncle->color == RED) {
-                    grandParent->color = RED;
-                    parent->color = BLACK;
-                    uncle->color = BLACK;
-                    node = grandParent;
-                } else {
-                    if (node == parent->left) {
-                        rotateRight(root, parent);
-                        node = parent;
-                        parent = node->parent;
-                    }
-
-                    rotateLeft(root, grandParent);
-                    swap(parent->color, grandParent->color);
-                    node = parent;
-                }
-            }
-        }
-
-        root->color = BLACK;
-    }
-
-    // Fix Red-Black Tree violations after deletion
-    void resolveDelete(Node*& root, Node* node, Node* parentNode) {
-        while (node != root && (node == nullptr || node->color == BLACK)) {
-            if (node == parentNode->left) {
-                Node* sibling = parentNode->right;
-
-                // Case 1: Sibling is red
-                if (sibling->color == RED) {
-                    sibling->color = BLACK;
-                    parentNode->color = RED;
-                    rotateLeft(root, parentNode);
-                    sibling = parentNode->right;
-                }
-
-                // Case 2: Sibling's children are black
-                if ((sibling->left == nullptr || sibling->left->color == BLACK) &&
-                    (sibling->right == nullptr || sibling->right->color == BLACK)) {
-                    sibling->color = RED;
-                    node = parentNode;
-                    parentNode = node->parent;
-                } else {
-                    // Case 3: Sibling's right child is black
-                    if (sibling->right == nullptr || sibling->right->color == BLACK) {
-                        if (sibling->left != nullptr)
-                            sibling->left->color = BLACK;
-                        sibling->color = RED;
-                        rotateRight(root, sibling);
-                        sibling = parentNode->right;
-                    }
-
-                    // Case 4: Sibling's right child is red
-                    sibling->color = parentNode->color;
-                    parentNode->color = BLACK;
-                    if (sibling->right != nullptr)
-                        sibling->right->color = BLACK;
-                    rotateLeft(root, parentNode);
-                    node = root;
-                    break;
-                }
-            } else {
-                // Mirror cases for right child
-                Node* sibling = parentNode->left;
-
-                // Case 1: Sibling is red
-                if (sibling->color == RED) {
-                    sibling->color = BLACK;
-                    parentNode->color = RED;
-                    rotateRight(root, parentNode);
-                    sibling = parentNode->left;
-                }
-
-                // Case 2: Sibling's children are black
-                if ((sibling->right == nullptr || sibling->right->color == BLACK) &&
-                    (sibling->left == nullptr || sibling->left->color == BLACK)) {
-                    sibling->color = RED;
-                    node = parentNode;
-                    parentNode = node->parent;
-                } else {
-                    // Case 3: Sibling's left child is black
-                    if (sibling->left == nullptr || sibling->left->color == BLACK) {
-                        if (sibling->right != nullptr)
-                            sibling->right->color = BLACK;
-                        sibling->color = RED;
-                        rotateLeft(root, sibling);
-                        sibling = parentNode->left;
-                    }
-
-                    // Case 4: Sibling's left child is red
-                    sibling->color = parentNode->color;
-                    parentNode->color = BLACK;
-                    if (sibling->left != nullptr)
-                        sibling->left->color = BLACK;
-                    rotateRight(root, parentNode);
-                    node = root;
-                    break;
-                }
-            }
-        }
-
-        if (node != nullptr)
-            node->color = BLACK;
-    }
-
+            return;
 
-    Node* findMinNode(Node* node) {
-        Node* current = node;
-        while (current && current->left != nullptr)
-            current = current->left;
-        return current;
+        inorderVisit(root->left, visit);
+        visit(root->key);
+        inorderVisit(root->right, visit);
     }
 
 
@@ -231,51 +63,68 @@ private:
     }
 
 
-    Node* deleteNode(Node* root, int key) {
-        if (root == nullptr) return root;
+    Node* findNode(int key) {
+        Node* current = root;
+        while (current != nullptr && current->key != key)
+            current = (key < current->key) ? current->left : current->right;
+        return current;
+    }
 
-        if (key < root->key)
-            root->left = deleteNode(root->left, key);
-        else if (key > root->key)
-            root->right = deleteNode(root->right, key);
-        else {
-            Node* replacement = nullptr;
-            NodeColor originalColor;
-
-            if (root->left == nullptr || root->right == nullptr) {
-                Node* child = (root->left != nullptr) ? root->left : root->right;
-                originalColor = root->color;
-
-                if (child == nullptr) {
-                    replacement = root;
-                    root = nullptr;
-                } else {
-                    *root = *child;
-                    replacement = root;
-                    delete child;
-                }
-
-                if (originalColor == BLACK) {
-                    resolveDelete(this->root, replacement, replacement->parent);
-                }
-            } else {
-                Node* successor = findMinNode(root->right);
-                root->key = successor->key;
-                originalColor = successor->color;
+    bool deleteNode(int key) {
+        Node* target = findNode(key);
+        if (target == nullptr)
+            return false;
+        unlink(target);
+        delete target;
+        return true;
+    }
+
+    // Build a perfectly balanced subtree from keys[lo, hi). Every level above
+    // redDepth is full, so coloring exactly the nodes at redDepth red keeps all
+    // black heights equal without any rotations.
+    Node* buildBalanced(const int* keys, long long lo, long long hi, int depth, int redDepth, Node* parent) {
+        if (lo >= hi)
+            return nullptr;
+        long long mid = lo + (hi - lo) / 2;
+        Node* node = new Node(keys[mid]);
+        node->parent = parent;
+        node->color = (depth == redDepth && depth > 0) ? RED : BLACK;
+        node->left = buildBalanced(keys, lo, mid, depth + 1, redDepth, node);
+        node->right = buildBalanced(keys, mid + 1, hi, depth + 1, redDepth, node);
+        return node;
+    }
 
-                root->right = deleteNode(root->right, successor->key);
+    // Replace the tree with one built from a strictly ascending key array
+    bool buildFromSorted(const int* keys, long long count) {
+        for (long long i = 1; i < count; i++)
+            if (keys[i - 1] >= keys[i])
+                return false;
+
+        destroy(root);
+        int redDepth = 0;
+        while ((2LL << redDepth) <= count) // redDepth = floor(log2(count))
+            redDepth++;
+        root = buildBalanced(keys, 0, count, 0, redDepth, nullptr);
+        return true;
+    }
 
-                if (originalColor == BLACK) {
-                    Node* replacementChild = (root->right != nullptr) ? root->right : nullptr;
-                    resolveDelete(this->root, replacementChild, root);
-                }
-            }
+    void collectDepths(Node* node, int depth, int blackDepth, vector<long long>& depthHistogram,
+                       vector<long long>& blackHeightHistogram) {
+        if (node == nullptr) {
+            if ((int)blackHeightHistogram.size() <= blackDepth)
+                blackHeightHistogram.resize(blackDepth + 1, 0);
+            blackHeightHistogram[blackDepth]++;
+            return;
         }
+        if ((int)depthHistogram.size() <= depth)
+            depthHistogram.resize(depth + 1, 0);
+        depthHistogram[depth]++;
 
-        return root;
+        int childBlackDepth = blackDepth + (node->color == BLACK ? 1 : 0);
+        collectDepths(node->left, depth + 1, childBlackDepth, depthHistogram, blackHeightHistogram);
+        collectDepths(node->right, depth + 1, childBlackDepth, depthHistogram, blackHeightHistogram);
     }
 
-
     void displayTree(Node* root, string indent = "", bool last = true) {
         if (root != nullptr) {
             cout << indent;
@@ -295,7 +144,12 @@ private:
     }
 
 public:
-    RBTree() { root = nullptr; }
+    RBTree(bool verbose = true) : verbose(verbose) {}
+
+    ~RBTree() { destroy(root); }
+
+    RBTree(const RBTree&) = delete;
+    RBTree& operator=(const RBTree&) = delete;
 
     bool find(Node* root, int key) {
         if (root == nullptr)
@@ -310,29 +164,48 @@ public:
             return find(root->right, key);
     }
 
+    bool find(int key) {
+        return find(root, key);
+    }
+
     void add(int key) {
-        cout << "Adding node with key: " << key << endl;
+        if (verbose)
+            cout << "Adding node with key: " << key << endl;
 
-        if (find(root, key)) {
-            cout << "Duplicate key detected! Node with key " << key << " already exists in the tree." << endl;
+        Node* parent = nullptr;
+        Node* current = root;
+        while (current != nullptr && current->key != key) {
+            parent = current;
+            current = (key < current->key) ? current->left : current->right;
+        }
+        if (current != nullptr) {
+            if (verbose)
+                cout << "Duplicate key detected! Node with key " << key << " already exists in the tree." << endl;
             return;
         }
 
-        Node* newNode = new Node(key);
-        root = insertToBST(root, newNode);
-        resolveInsert(root, newNode);
-        cout << "After balancing:\n";
-        displayTree(root);
+        attach(parent, parent != nullptr && key < parent->key, new Node(key));
+        if (verbose) {
+            cout << "After balancing:\n";
+            displayTree(root);
+        }
     }
 
     void Delete(int key) {
         if (root == nullptr) {
-            cout << "Tree is empty. Nothing to delete." << endl;
+            if (verbose)
+                cout << "Tree is empty. Nothing to delete." << endl;
+            return;
+        }
+        if (!deleteNode(key)) {
+            if (verbose)
+                cout << "Key " << key << " not found." << endl;
             return;
         }
-        root = deleteNode(root, key);
-        cout << "After deleting " << key << ":\n";
-        displayTree(root);
+        if (verbose) {
+            cout << "After deleting " << key << ":\n";
+            displayTree(root);
+        }
     }
 
     void inorder() {
@@ -342,8 +215,124 @@ public:
         }
         inorderPrint(root);
     }
+
+    // Write the keys as a sorted array so a reload costs one sequential read
+    bool save(const string& path) {
+        vector<int> keys;
+        auto collect = [&keys](int key) { keys.push_back(key); };
+        inorderVisit(root, collect);
+
+        RBTreeFileHeader header;
+        memcpy(header.magic, "RBT1", 4);
+        header.keyBytes = sizeof(int);
+        header.count = keys.size();
+
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(int));
+        return bool(out);
+    }
+
+    // Replace the tree with the contents of a file written by save(). The key
+    // array is mapped straight from the page cache where mmap is available and
+    // the tree is rebuilt in O(n) instead of n * log n inserts. The file must
+    // be exactly the header plus count keys. On any error the current tree is
+    // left untouched.
+    bool load(const string& path) {
+#ifdef RBT_HAVE_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(RBTreeFileHeader)) {
+            close(fd);
+            return false;
+        }
+        size_t length = info.st_size;
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+            return false;
+        madvise(mapped, length, MADV_SEQUENTIAL);
+
+        const RBTreeFileHeader* header = static_cast<const RBTreeFileHeader*>(mapped);
+        const int* keys = reinterpret_cast<const int*>(header + 1);
+        bool ok = memcmp(header->magic, "RBT1", 4) == 0 && header->keyBytes == sizeof(int) &&
+                  (length - sizeof(RBTreeFileHeader)) % sizeof(int) == 0 &&
+                  header->count == (length - sizeof(RBTreeFileHeader)) / sizeof(int) &&
+                  buildFromSorted(keys, header->count);
+        munmap(mapped, length);
+        return ok;
+#else
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in)
+            return false;
+        uint64_t length = uint64_t(in.tellg());
+        in.seekg(0);
+        RBTreeFileHeader header;
+        if (length < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            memcmp(header.magic, "RBT1", 4) != 0 || header.keyBytes != sizeof(int) ||
+            (length - sizeof(header)) % sizeof(int) != 0 || header.count != (length - sizeof(header)) / sizeof(int))
+            return false;
+        vector<int> keys(header.count);
+        if (!in.read(reinterpret_cast<char*>(keys.data()), keys.size() * sizeof(int)))
+            return false;
+        return buildFromSorted(keys.data(), keys.size());
+#endif
+    }
+
+    // O(n) check of BST order, parent links, root color, no red-red edges and
+    // equal black heights. On failure a description is stored in error.
+    bool validate(string* error = nullptr) {
+        return validateTree([](int a, int b) { return a < b; }, error);
+    }
+
+    // Counters plus node-depth and per-leaf black-height histograms, as JSON
+    string statsJson() {
+        vector<long long> depthHistogram, blackHeightHistogram;
+        collectDepths(root, 0, 0, depthHistogram, blackHeightHistogram);
+
+        long long size = 0;
+        for (long long count : depthHistogram)
+            size += count;
+
+        string error;
+        bool valid = validate(&error);
+
+        ostringstream out;
+        out << "{\"inserts\":" << stats.inserts
+            << ",\"deletes\":" << stats.deletes
+            << ",\"rotations\":" << stats.rotations
+            << ",\"recolors\":" << stats.recolors
+            << ",\"insertFixups\":" << stats.insertFixups
+            << ",\"deleteFixups\":" << stats.deleteFixups
+            << ",\"size\":" << size
+            << ",\"height\":" << depthHistogram.size()
+            << ",\"depthHistogram\":[";
+        for (size_t i = 0; i < depthHistogram.size(); i++)
+            out << (i ? "," : "") << depthHistogram[i];
+        out << "],\"blackHeightHistogram\":[";
+        for (size_t i = 0; i < blackHeightHistogram.size(); i++)
+            out << (i ? "," : "") << blackHeightHistogram[i];
+        out << "],\"valid\":" << (valid ? "true" : "false");
+        if (!valid)
+            out << ",\"error\":\"" << error << "\"";
+        out << "}";
+        return out.str();
+    }
+
+    // Visit every key in ascending order without printing
+    template <typename Visitor>
+    void inorder(Visitor visit) {
+        inorderVisit(root, visit);
+    }
 };
 
+// Define RBT_NO_MAIN to include this file from another program (e.g. a benchmark)
+#ifndef RBT_NO_MAIN
+
 
 int getValidInput() {
     int key;
@@ -360,14 +349,19 @@ int getValidInput() {
 
 int main() {
     RBTree tree;
+    tree.enableStats();
     int choice, key;
+    string path;
 
     do {
         cout << "\nRB Tree Operations Menu\n";
         cout << "1. Add Node\n";
         cout << "2. Delete Node\n";
         cout << "3. Display Inorder Traversal\n";
-        cout << "4. Exit\n";
+        cout << "4. Show Statistics (JSON)\n";
+        cout << "5. Save Tree to File\n";
+        cout << "6. Load Tree from File\n";
+        cout << "7. Exit\n";
         cout << "Enter your choice: ";
         choice = getValidInput();
 
@@ -387,12 +381,26 @@ int main() {
                 tree.inorder();
                 break;
             case 4:
+                cout << tree.statsJson() << endl;
+                break;
+            case 5:
+                cout << "Enter the file path: ";
+                cin >> path;
+                cout << (tree.save(path) ? "Tree saved." : "Could not write the file.") << endl;
+                break;
+            case 6:
+                cout << "Enter the file path: ";
+                cin >> path;
+                cout << (tree.load(path) ? "Tree loaded." : "Could not load the file.") << endl;
+                break;
+            case 7:
                 cout << "Exiting...\n";
                 break;
             default:
                 cout << "Invalid choice! Please try again." << endl;
         }
-    } while (choice != 4);
+    } while (choice != 7);
 
     return 0;
 }
+#endif // RBT_NO_MAIN
@@ -0,0 +1,367 @@
+#ifndef RBTREE_CORE_H
+#define RBTREE_CORE_H
+
+#include <string>
+#include <type_traits>
+
+// Red-black balancing shared by RBTree (RBT.cpp) and RBTreeMap (RBTreeMap.cpp).
+// Node can be any type with key, color, left, right and parent members; the
+// trees keep their own search and node construction and call in here to link,
+// unlink and rebalance.
+
+enum NodeColor { RED, BLACK };
+
+// Rebalancing work counters, collected only after enableStats()
+struct RBTreeStats {
+    long long inserts = 0;
+    long long deletes = 0;
+    long long rotations = 0;
+    long long recolors = 0;      // Color assignments that actually changed a node
+    long long insertFixups = 0;  // resolveInsert loop iterations
+    long long deleteFixups = 0;  // resolveDelete loop iterations
+};
+
+// Key text for validation messages
+template <typename Key>
+std::string describeKey(const Key& key) {
+    if constexpr (std::is_arithmetic<Key>::value)
+        return std::to_string(key);
+    else if constexpr (std::is_convertible<const Key&, std::string>::value)
+        return "\"" + std::string(key) + "\"";
+    else
+        return "(key)";
+}
+
+template <typename Node>
+class RBTreeCore {
+protected:
+    Node* root;
+    bool collectStats;
+    RBTreeStats stats;
+
+    RBTreeCore() : root(nullptr), collectStats(false) {}
+
+    void recolor(Node* node, NodeColor color) {
+        if (collectStats && node->color != color)
+            stats.recolors++;
+        node->color = color;
+    }
+
+    void swapColors(Node* a, Node* b) {
+        NodeColor aColor = a->color;
+        recolor(a, b->color);
+        recolor(b, aColor);
+    }
+
+    void rotateLeft(Node* node) {
+        if (collectStats) stats.rotations++;
+        Node* rightChild = node->right;
+
+        node->right = rightChild->left;
+        if (node->right != nullptr)
+            node->right->parent = node;
+
+        rightChild->parent = node->parent;
+        if (node->parent == nullptr)
+            root = rightChild;
+        else if (node == node->parent->left)
+            node->parent->left = rightChild;
+        else
+            node->parent->right = rightChild;
+
+        rightChild->left = node;
+        node->parent = rightChild;
+    }
+
+    void rotateRight(Node* node) {
+        if (collectStats) stats.rotations++;
+        Node* leftChild = node->left;
+
+        node->left = leftChild->right;
+        if (node->left != nullptr)
+            node->left->parent = node;
+
+        leftChild->parent = node->parent;
+        if (node->parent == nullptr)
+            root = leftChild;
+        else if (node == node->parent->left)
+            node->parent->left = leftChild;
+        else
+            node->parent->right = leftChild;
+
+        leftChild->right = node;
+        node->parent = leftChild;
+    }
+
+    // Fix Red-Black Tree violations after node was linked in as a red leaf
+    void resolveInsert(Node* node) {
+        while ((node != root) && (node->color == RED) && (node->parent->color == RED)) {
+            if (collectStats) stats.insertFixups++;
+            Node* parent = node->parent;
+            Node* grandParent = parent->parent;
+
+            if (parent == grandParent->left) {
+                Node* uncle = grandParent->right;
+
+                if (uncle != nullptr && uncle->color == RED) {
+                    recolor(grandParent, RED);
+                    recolor(parent, BLACK);
+                    recolor(uncle, BLACK);
+                    node = grandParent;
+                } else {
+                    if (node == parent->right) {
+                        rotateLeft(parent);
+                        node = parent;
+                        parent = node->parent;
+                    }
+
+                    rotateRight(grandParent);
+                    swapColors(parent, grandParent);
+                    node = parent;
+                }
+            } else {
+                Node* uncle = grandParent->left;
+
+                if (uncle != nullptr && uncle->color == RED) {
+                    recolor(grandParent, RED);
+                    recolor(parent, BLACK);
+                    recolor(uncle, BLACK);
+                    node = grandParent;
+                } else {
+                    if (node == parent->left) {
+                        rotateRight(parent);
+                        node = parent;
+                        parent = node->parent;
+                    }
+
+                    rotateLeft(grandParent);
+                    swapColors(parent, grandParent);
+                    node = parent;
+                }
+            }
+        }
+
+        recolor(root, BLACK);
+    }
+
+    // Fix Red-Black Tree violations after deletion
+    void resolveDelete(Node* node, Node* parentNode) {
+        while (node != root && (node == nullptr || node->color == BLACK)) {
+            if (collectStats) stats.deleteFixups++;
+            if (node == parentNode->left) {
+                Node* sibling = parentNode->right;
+
+                // Case 1: Sibling is red
+                if (sibling->color == RED) {
+                    recolor(sibling, BLACK);
+                    recolor(parentNode, RED);
+                    rotateLeft(parentNode);
+                    sibling = parentNode->right;
+                }
+
+                // Case 2: Sibling's children are black
+                if ((sibling->left == nullptr || sibling->left->color == BLACK) &&
+                    (sibling->right == nullptr || sibling->right->color == BLACK)) {
+                    recolor(sibling, RED);
+                    node = parentNode;
+                    parentNode = node->parent;
+                } else {
+                    // Case 3: Sibling's right child is black
+                    if (sibling->right == nullptr || sibling->right->color == BLACK) {
+                        if (sibling->left != nullptr)
+                            recolor(sibling->left, BLACK);
+                        recolor(sibling, RED);
+                        rotateRight(sibling);
+                        sibling = parentNode->right;
+                    }
+
+                    // Case 4: Sibling's right child is red
+                    recolor(sibling, parentNode->color);
+                    recolor(parentNode, BLACK);
+                    if (sibling->right != nullptr)
+                        recolor(sibling->right, BLACK);
+                    rotateLeft(parentNode);
+                    node = root;
+                    break;
+                }
+            } else {
+                // Mirror cases for right child
+                Node* sibling = parentNode->left;
+
+                // Case 1: Sibling is red
+                if (sibling->color == RED) {
+                    recolor(sibling, BLACK);
+                    recolor(parentNode, RED);
+                    rotateRight(parentNode);
+                    sibling = parentNode->left;
+                }
+
+                // Case 2: Sibling's children are black
+                if ((sibling->right == nullptr || sibling->right->color == BLACK) &&
+                    (sibling->left == nullptr || sibling->left->color == BLACK)) {
+                    recolor(sibling, RED);
+                    node = parentNode;
+                    parentNode = node->parent;
+                } else {
+                    // Case 3: Sibling's left child is black
+                    if (sibling->left == nullptr || sibling->left->color == BLACK) {
+                        if (sibling->right != nullptr)
+                            recolor(sibling->right, BLACK);
+                        recolor(sibling, RED);
+                        rotateLeft(sibling);
+                        sibling = parentNode->left;
+                    }
+
+                    // Case 4: Sibling's left child is red
+                    recolor(sibling, parentNode->color);
+                    recolor(parentNode, BLACK);
+                    if (sibling->left != nullptr)
+                        recolor(sibling->left, BLACK);
+                    rotateRight(parentNode);
+                    node = root;
+                    break;
+                }
+            }
+        }
+
+        if (node != nullptr)
+            recolor(node, BLACK);
+    }
+
+    static Node* findMinNode(Node* node) {
+        Node* current = node;
+        while (current && current->left != nullptr)
+            current = current->left;
+        return current;
+    }
+
+    // Link a new red leaf under parent (nullptr for an empty tree) and rebalance
+    void attach(Node* parent, bool asLeftChild, Node* node) {
+        node->parent = parent;
+        if (parent == nullptr)
+            root = node;
+        else if (asLeftChild)
+            parent->left = node;
+        else
+            parent->right = node;
+        if (collectStats) stats.inserts++;
+        resolveInsert(node);
+    }
+
+    // Replace the subtree rooted at oldNode with the one rooted at newNode
+    void transplant(Node* oldNode, Node* newNode) {
+        if (oldNode->parent == nullptr)
+            root = newNode;
+        else if (oldNode == oldNode->parent->left)
+            oldNode->parent->left = newNode;
+        else
+            oldNode->parent->right = newNode;
+        if (newNode != nullptr)
+            newNode->parent = oldNode->parent;
+    }
+
+    // Unlink target by relinking pointers (nodes are never copied over each
+    // other), then restore the red-black properties. The caller frees target.
+    void unlink(Node* target) {
+        NodeColor removedColor = target->color;
+        Node* replacement;       // Node that moves into the removed position (may be nullptr)
+        Node* replacementParent; // Its parent after the unlink
+
+        if (target->left == nullptr) {
+            replacement = target->right;
+            replacementParent = target->parent;
+            transplant(target, target->right);
+        } else if (target->right == nullptr) {
+            replacement = target->left;
+            replacementParent = target->parent;
+            transplant(target, target->left);
+        } else {
+            Node* successor = findMinNode(target->right);
+            removedColor = successor->color;
+            replacement = successor->right;
+
+            if (successor->parent == target) {
+                replacementParent = successor;
+            } else {
+                replacementParent = successor->parent;
+                transplant(successor, successor->right);
+                successor->right = target->right;
+                successor->right->parent = successor;
+            }
+
+            transplant(target, successor);
+            successor->left = target->left;
+            successor->left->parent = successor;
+            successor->color = target->color;
+        }
+
+        if (collectStats) stats.deletes++;
+        if (removedColor == BLACK)
+            resolveDelete(replacement, replacementParent);
+    }
+
+    void destroy(Node* node) {
+        if (node == nullptr)
+            return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+    // Returns the black height of the subtree, or -1 after recording the first violation
+    template <typename Less>
+    int validateSubtree(const Node* node, const Node* parent, const Node* low, const Node* high, Less& less,
+                        std::string& error) const {
+        if (node == nullptr)
+            return 1;
+
+        if (node->parent != parent) {
+            error = "parent pointer of " + describeKey(node->key) + " is wrong";
+            return -1;
+        }
+        if ((low != nullptr && !less(low->key, node->key)) || (high != nullptr && !less(node->key, high->key))) {
+            error = "key " + describeKey(node->key) + " breaks BST order";
+            return -1;
+        }
+        if (node->color == RED && parent != nullptr && parent->color == RED) {
+            error = "red node " + describeKey(node->key) + " has a red parent";
+            return -1;
+        }
+
+        int leftHeight = validateSubtree(node->left, node, low, node, less, error);
+        if (leftHeight < 0)
+            return -1;
+        int rightHeight = validateSubtree(node->right, node, node, high, less, error);
+        if (rightHeight < 0)
+            return -1;
+        if (leftHeight != rightHeight) {
+            error = "black heights differ below " + describeKey(node->key);
+            return -1;
+        }
+        return leftHeight + (node->color == BLACK ? 1 : 0);
+    }
+
+    // O(n) check of BST order under less, parent links, root color, no red-red
+    // edges and equal black heights. On failure a description is stored in error.
+    template <typename Less>
+    bool validateTree(Less less, std::string* error) const {
+        std::string message;
+        bool valid = true;
+        if (root != nullptr && root->color != BLACK) {
+            message = "root is red";
+            valid = false;
+        } else {
+            valid = validateSubtree(root, nullptr, nullptr, nullptr, less, message) >= 0;
+        }
+        if (error != nullptr)
+            *error = message;
+        return valid;
+    }
+
+public:
+    void enableStats(bool enabled = true) { collectStats = enabled; }
+    void resetStats() { stats = RBTreeStats(); }
+    const RBTreeStats& getStats() const { return stats; }
+};
+
+#endif // RBTREE_CORE_H
@@ -0,0 +1,240 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "RBTreeCore.h"
+using namespace std;
+
+// Generic red-black tree map: the balancing code in RBTreeCore.h that RBTree
+// also uses, but each node carries a Value constructed in place and keys are
+// ordered by Compare.
+
+template <typename Key, typename Value>
+struct MapNode {
+    Key key;
+    Value value;
+    NodeColor color;
+    MapNode* left, * right, * parent;
+
+    template <typename KeyArg, typename... ValueArgs>
+    MapNode(KeyArg&& keyArg, ValueArgs&&... valueArgs)
+        : key(forward<KeyArg>(keyArg)), value(forward<ValueArgs>(valueArgs)...),
+          color(RED), left(nullptr), right(nullptr), parent(nullptr) {}
+};
+
+template <typename Key, typename Value, typename Compare = less<Key>>
+class RBTreeMap : public RBTreeCore<MapNode<Key, Value>> {
+private:
+    typedef MapNode<Key, Value> Node;
+    typedef RBTreeCore<Node> Base;
+    using Base::root;
+
+    // Built-in keys under std::less compile to the same == / < pair that
+    // RBTree uses; any other comparator needs two calls to detect equality.
+    // RBTreeMapBenchmark.cpp measures the difference.
+    static constexpr bool nativeOrder =
+        is_arithmetic<Key>::value && (is_same<Compare, less<Key>>::value || is_same<Compare, less<>>::value);
+
+    size_t count;
+    Compare comp;
+
+    // -1, 0 or 1 as a orders before, equal to or after b
+    template <typename A, typename B>
+    int compareKeys(const A& a, const B& b) const {
+        if constexpr (nativeOrder) {
+            return (a == b) ? 0 : (a < b ? -1 : 1);
+        } else {
+            if (comp(a, b))
+                return -1;
+            return comp(b, a) ? 1 : 0;
+        }
+    }
+
+    template <typename K>
+    Node* findNode(const K& key) const {
+        Node* current = root;
+        while (current != nullptr) {
+            int order = compareKeys(key, current->key);
+            if (order == 0)
+                return current;
+            current = (order < 0) ? current->left : current->right;
+        }
+        return nullptr;
+    }
+
+    // Link an already constructed node under parent (nullptr for an empty tree)
+    void attach(Node* parent, int order, Node* node) {
+        count++;
+        Base::attach(parent, order < 0, node);
+    }
+
+    // Locate key; returns the matching node or nullptr plus the parent/side to attach at
+    template <typename K>
+    Node* locate(const K& key, Node*& parent, int& order) const {
+        Node* current = root;
+        parent = nullptr;
+        order = 0;
+        while (current != nullptr) {
+            order = compareKeys(key, current->key);
+            if (order == 0)
+                return current;
+            parent = current;
+            current = (order < 0) ? current->left : current->right;
+        }
+        return nullptr;
+    }
+
+    template <typename Visitor>
+    void inorderVisit(Node* node, Visitor& visit) const {
+        if (node == nullptr)
+            return;
+        inorderVisit(node->left, visit);
+        visit(static_cast<const Key&>(node->key), node->value);
+        inorderVisit(node->right, visit);
+    }
+
+public:
+    RBTreeMap(const Compare& comp = Compare()) : count(0), comp(comp) {}
+
+    ~RBTreeMap() { this->destroy(root); }
+
+    RBTreeMap(const RBTreeMap&) = delete;
+    RBTreeMap& operator=(const RBTreeMap&) = delete;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Build the node (and its value) from the arguments first, then link it.
+    // If the key is already present the new node is discarded, as std::map does.
+    // Returns the value stored under the key and whether an insertion happened.
+    template <typename KeyArg, typename... ValueArgs>
+    pair<Value*, bool> emplace(KeyArg&& key, ValueArgs&&... valueArgs) {
+        Node* node = new Node(forward<KeyArg>(key), forward<ValueArgs>(valueArgs)...);
+        Node* parent;
+        int order;
+        Node* existing = locate(node->key, parent, order);
+        if (existing != nullptr) {
+            delete node;
+            return make_pair(&existing->value, false);
+        }
+        attach(parent, order, node);
+        return make_pair(&node->value, true);
+    }
+
+    // Search first and only construct the value when the key is absent, so a
+    // duplicate costs no allocation and large payload arguments are not consumed.
+    template <typename KeyArg, typename... ValueArgs>
+    pair<Value*, bool> try_emplace(KeyArg&& key, ValueArgs&&... valueArgs) {
+        Node* parent;
+        int order;
+        Node* existing = locate(key, parent, order);
+        if (existing != nullptr)
+            return make_pair(&existing->value, false);
+
+        Node* node = new Node(forward<KeyArg>(key), forward<ValueArgs>(valueArgs)...);
+        attach(parent, order, node);
+        return make_pair(&node->value, true);
+    }
+
+    bool insert(const Key& key, const Value& value) { return try_emplace(key, value).second; }
+    bool insert(Key&& key, Value&& value) { return try_emplace(move(key), move(value)).second; }
+
+    Value& operator[](const Key& key) { return *try_emplace(key).first; }
+
+    // Returns nullptr when the key is absent
+    Value* find(const Key& key) {
+        Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    const Value* find(const Key& key) const {
+        Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    // Heterogeneous lookup (e.g. string keys probed with a const char*),
+    // available when the comparator declares is_transparent like std::less<>
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value* find(const K& key) {
+        Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    const Value* find(const K& key) const {
+        Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    bool contains(const Key& key) const { return findNode(key) != nullptr; }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const K& key) const { return findNode(key) != nullptr; }
+
+    bool erase(const Key& key) {
+        Node* target = findNode(key);
+        if (target == nullptr)
+            return false;
+
+        this->unlink(target);
+        delete target;
+        count--;
+        return true;
+    }
+
+    // O(n) red-black invariant check, as RBTree::validate
+    bool validate(string* error = nullptr) const {
+        return this->validateTree([this](const Key& a, const Key& b) { return compareKeys(a, b) < 0; }, error);
+    }
+
+    // Visit (key, value) pairs in key order
+    template <typename Visitor>
+    void inorder(Visitor visit) const {
+        inorderVisit(root, visit);
+    }
+};
+
+// Define RBTREEMAP_NO_MAIN to include this file from another program
+#ifndef RBTREEMAP_NO_MAIN
+struct PlayerRecord {
+    string name;
+    vector<int> history; // Large payload that should never be copied on insert
+
+    PlayerRecord(string name, vector<int> history) : name(move(name)), history(move(history)) {}
+};
+
+int main() {
+    // int -> record index; the record is built inside the tree node
+    RBTreeMap<int, PlayerRecord> records;
+    records.try_emplace(42, "Alice", vector<int>(1000, 7));
+    records.try_emplace(7, "Bob", vector<int>{1, 2, 3});
+    records.try_emplace(19, "Carol", vector<int>{4, 5});
+
+    bool inserted = records.try_emplace(42, "Duplicate", vector<int>()).second;
+    cout << "Insert duplicate key 42: " << (inserted ? "inserted" : "rejected") << endl;
+
+    PlayerRecord* alice = records.find(42);
+    if (alice != nullptr)
+        cout << "Key 42 -> " << alice->name << " (" << alice->history.size() << " entries)" << endl;
+
+    records.erase(7);
+    cout << "Records in key order:" << endl;
+    records.inorder([](int key, const PlayerRecord& record) {
+        cout << "  " << key << ": " << record.name << endl;
+    });
+
+    // Transparent comparator: look up string keys with a const char* without building a string
+    RBTreeMap<string, int, less<>> scores;
+    scores.emplace("zed", 10);
+    scores.emplace("amy", 30);
+    scores["bob"] = 20;
+
+    const int* amy = scores.find("amy");
+    cout << "Score of amy: " << (amy ? *amy : -1) << endl;
+    cout << "Contains \"max\": " << (scores.contains("max") ? "yes" : "no") << endl;
+
+    return 0;
+}
+#endif // RBTREEMAP_NO_MAIN
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#define RBT_NO_MAIN
+#include "RBT.cpp"
+#define RBTREEMAP_NO_MAIN
+#include "RBTreeMap.cpp"
+
+using namespace std;
+
+// Measures the int-key fast path of RBTreeMap: under std::less an int key is
+// compared with one == / < pair, as in RBTree, while any other comparator
+// needs two comparator calls per node to detect equality. OpaqueLess orders
+// ints exactly like std::less<int> but is not recognised, so it takes the
+// generic path. RBTree is included as the baseline the map should match.
+// Usage: ./RBTreeMapBenchmark [n1 n2 ...]   (default sizes 1000 10000 100000 1000000)
+
+struct OpaqueLess {
+    bool operator()(int a, int b) const { return a < b; }
+};
+
+struct Timings {
+    double insertNs, lookupNs, eraseNs;
+    long long checksum;
+};
+
+double elapsedNs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Map>
+Timings runMap(const vector<int>& keys, const vector<int>& probes) {
+    Timings result;
+    Map map;
+    auto start = chrono::steady_clock::now();
+    for (int key : keys)
+        map.try_emplace(key, key);
+    result.insertNs = elapsedNs(start) / keys.size();
+
+    long long hits = 0;
+    start = chrono::steady_clock::now();
+    for (int key : probes) {
+        const int* value = map.find(key);
+        if (value != nullptr)
+            hits += *value;
+    }
+    result.lookupNs = elapsedNs(start) / probes.size();
+
+    start = chrono::steady_clock::now();
+    for (int key : keys)
+        map.erase(key);
+    result.eraseNs = elapsedNs(start) / keys.size();
+    result.checksum = hits;
+    return result;
+}
+
+Timings runSet(const vector<int>& keys, const vector<int>& probes) {
+    Timings result;
+    RBTree tree(false);
+    auto start = chrono::steady_clock::now();
+    for (int key : keys)
+        tree.add(key);
+    result.insertNs = elapsedNs(start) / keys.size();
+
+    long long hits = 0;
+    start = chrono::steady_clock::now();
+    for (int key : probes)
+        if (tree.find(key))
+            hits += key;
+    result.lookupNs = elapsedNs(start) / probes.size();
+
+    start = chrono::steady_clock::now();
+    for (int key : keys)
+        tree.Delete(key);
+    result.eraseNs = elapsedNs(start) / keys.size();
+    result.checksum = hits;
+    return result;
+}
+
+void printRow(int n, const char* name, const Timings& timings) {
+    cout << setw(10) << n << setw(28) << name << setw(14) << timings.insertNs << setw(14) << timings.lookupNs
+         << setw(14) << timings.eraseNs << endl;
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(atoi(argv[i]));
+    if (sizes.empty())
+        sizes = {1000, 10000, 100000, 1000000};
+
+    cout << fixed << setprecision(1);
+    cout << setw(10) << "n" << setw(28) << "tree"
+         << setw(14) << "insert ns/op" << setw(14) << "lookup ns/op" << setw(14) << "erase ns/op" << endl;
+
+    for (int n : sizes) {
+        mt19937 rng(42);
+        vector<int> keys(n);
+        for (int i = 0; i < n; i++)
+            keys[i] = i * 2; // Even keys, so odd probes miss
+        shuffle(keys.begin(), keys.end(), rng);
+
+        vector<int> probes(max(n, 1000000));
+        uniform_int_distribution<int> probeDist(0, 2 * n);
+        for (int& probe : probes)
+            probe = probeDist(rng);
+
+        Timings native = runMap<RBTreeMap<int, int>>(keys, probes);
+        Timings generic = runMap<RBTreeMap<int, int, OpaqueLess>>(keys, probes);
+        Timings baseline = runSet(keys, probes);
+
+        printRow(n, "RBTreeMap<int> less<int>", native);
+        printRow(n, "RBTreeMap<int> OpaqueLess", generic);
+        printRow(n, "RBTree", baseline);
+        cout << setw(38) << "fast path speedup"
+             << setw(13) << generic.insertNs / native.insertNs << "x" << setw(13) << generic.lookupNs / native.lookupNs
+             << "x" << setw(13) << generic.eraseNs / native.eraseNs << "x" << endl;
+
+        if (native.checksum != generic.checksum || native.checksum != baseline.checksum)
+            cout << "Checksum mismatch at n = " << n << "!" << endl;
+    }
+
+    return 0;
+}
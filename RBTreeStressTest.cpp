@@ -0,0 +1,162 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <random>
+#include <cstdlib>
+
+#define RBT_NO_MAIN
+#include "RBT.cpp"
+#define RBTREEMAP_NO_MAIN
+#include "RBTreeMap.cpp"
+
+using namespace std;
+
+// Randomized insert/delete stress test for RBTree and RBTreeMap, which share
+// the balancing code in RBTreeCore.h. Every operation is mirrored in a std::set
+// (std::map), and after each one validate() must pass and the tree must hold
+// exactly the keys of the model. Small key ranges keep duplicates, deletes of
+// missing keys and deletes of two-child nodes frequent.
+// Usage: ./RBTreeStressTest [operations] [seed]   (default 200000 operations, seed 1)
+
+bool sameKeys(RBTree& tree, const set<int>& model) {
+    bool same = true;
+    auto expected = model.begin();
+    tree.inorder([&](int key) {
+        if (expected == model.end() || *expected != key)
+            same = false;
+        else
+            ++expected;
+    });
+    return same && expected == model.end();
+}
+
+// Returns the number of the first failing operation, or 0 when all pass
+long long runStress(long long operations, int keyRange, unsigned seed, string& error) {
+    RBTree tree(false);
+    set<int> model;
+    mt19937 rng(seed);
+    uniform_int_distribution<int> keyDist(0, keyRange - 1);
+    uniform_int_distribution<int> opDist(0, 99);
+
+    for (long long op = 1; op <= operations; op++) {
+        // Drift between growing and shrinking phases so both fix-up paths run at every size
+        int insertPercent = (op / 1000) % 2 == 0 ? 65 : 35;
+        int key = keyDist(rng);
+        if (opDist(rng) < insertPercent) {
+            tree.add(key);
+            model.insert(key);
+        } else {
+            tree.Delete(key);
+            model.erase(key);
+        }
+
+        if (!tree.validate(&error))
+            return op;
+        if (tree.find(key) != (model.count(key) != 0)) {
+            error = "find(" + to_string(key) + ") disagrees with std::set";
+            return op;
+        }
+        // A full content comparison is O(n); do it often, not on every step
+        if ((op & 63) == 0 && !sameKeys(tree, model)) {
+            error = "key sequence differs from std::set";
+            return op;
+        }
+    }
+
+    // Drain completely: every remaining deletion must also keep the tree valid
+    for (int key : vector<int>(model.begin(), model.end())) {
+        tree.Delete(key);
+        if (!tree.validate(&error))
+            return operations + 1;
+    }
+    if (!sameKeys(tree, set<int>())) {
+        error = "tree is not empty after deleting every key";
+        return operations + 1;
+    }
+    return 0;
+}
+
+// Same workload against RBTreeMap<int, int> and std::map; values must follow their keys
+long long runMapStress(long long operations, int keyRange, unsigned seed, string& error) {
+    RBTreeMap<int, int> tree;
+    map<int, int> model;
+    mt19937 rng(seed);
+    uniform_int_distribution<int> keyDist(0, keyRange - 1);
+    uniform_int_distribution<int> opDist(0, 99);
+
+    for (long long op = 1; op <= operations; op++) {
+        int insertPercent = (op / 1000) % 2 == 0 ? 65 : 35;
+        int key = keyDist(rng);
+        if (opDist(rng) < insertPercent) {
+            int value = (int)op;
+            tree.try_emplace(key, value);
+            model.emplace(key, value);
+        } else {
+            tree.erase(key);
+            model.erase(key);
+        }
+
+        if (!tree.validate(&error))
+            return op;
+        const int* value = tree.find(key);
+        auto expected = model.find(key);
+        if ((value == nullptr) != (expected == model.end()) || (value != nullptr && *value != expected->second)) {
+            error = "find(" + to_string(key) + ") disagrees with std::map";
+            return op;
+        }
+        if (tree.size() != model.size()) {
+            error = "size " + to_string(tree.size()) + " differs from std::map";
+            return op;
+        }
+        if ((op & 63) == 0) {
+            bool same = true;
+            auto next = model.begin();
+            tree.inorder([&](int k, int v) {
+                if (next == model.end() || next->first != k || next->second != v)
+                    same = false;
+                else
+                    ++next;
+            });
+            if (!same || next != model.end()) {
+                error = "entry sequence differs from std::map";
+                return op;
+            }
+        }
+    }
+
+    for (auto& entry : map<int, int>(model)) {
+        tree.erase(entry.first);
+        if (!tree.validate(&error))
+            return operations + 1;
+    }
+    if (!tree.empty()) {
+        error = "map is not empty after erasing every key";
+        return operations + 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    long long operations = argc > 1 ? atoll(argv[1]) : 200000;
+    unsigned seed = argc > 2 ? (unsigned)atoi(argv[2]) : 1;
+
+    bool passed = true;
+    for (int keyRange : {16, 256, 4096}) {
+        for (bool testMap : {false, true}) {
+            string error;
+            long long failedAt = testMap ? runMapStress(operations, keyRange, seed, error)
+                                         : runStress(operations, keyRange, seed, error);
+            cout << (testMap ? "RBTreeMap" : "RBTree   ") << " key range " << keyRange << ": ";
+            if (failedAt == 0) {
+                cout << "passed " << operations << " operations" << endl;
+            } else {
+                cout << "FAILED at operation " << failedAt << ": " << error << endl;
+                passed = false;
+            }
+        }
+    }
+
+    return passed ? 0 : 1;
+}
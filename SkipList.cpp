@@ -2,55 +2,230 @@
 #include <cstdlib>
 #include <ctime>
 #include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <iterator>
 using namespace std;
 
-// Node structure for the skip list
+const int MAX_LEVEL_CAP = 32; // Upper bound on tower height, sizes the on-stack update arrays
+const size_t CACHE_LINE = 64;
+
+// Node structure for the skip list. The forward tower is stored inline right
+// after the value: a node of level L is allocated with room for L + 1 pointers,
+// so a hop reads the key and the next pointer from the same cache line.
+// The link spans follow the pointers and are only read by positional queries.
 struct Node {
     int value;
-    vector<Node*> forward; // Forward pointers at different levels
+    int level;        // Highest level this node is linked on
+    Node* forward[1]; // Forward pointers at different levels (really level + 1 entries)
+
+    // span()[i]: number of level-0 steps covered by forward[i]; for the last
+    // node on a level it is the count of nodes after this one (size - rank)
+    int* span() { return reinterpret_cast<int*>(forward + level + 1); }
+
+    static size_t bytesFor(int level) {
+        size_t bytes = offsetof(Node, forward) + (level + 1) * (sizeof(Node*) + sizeof(int));
+        return (bytes + alignof(Node) - 1) & ~(alignof(Node) - 1);
+    }
+};
+
+// Slab allocator for skip list nodes. Nodes are carved out of large aligned
+// blocks, removed nodes are kept on a free list per tower height for reuse,
+// and every node is released at once when the arena is destroyed.
+class NodeArena {
+    static const size_t BLOCK_BYTES = 64 * 1024;
+
+    vector<char*> blocks;
+    char* cursor;
+    size_t remaining;
+    Node* freeLists[MAX_LEVEL_CAP + 1]; // Chained through forward[0]
+
+public:
+    NodeArena() : cursor(nullptr), remaining(0) {
+        for (int i = 0; i <= MAX_LEVEL_CAP; i++)
+            freeLists[i] = nullptr;
+    }
+
+    ~NodeArena() {
+        for (char* block : blocks)
+            operator delete(block, align_val_t(CACHE_LINE));
+    }
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    Node* allocate(int value, int level) {
+        Node* node = freeLists[level];
+        if (node != nullptr) {
+            freeLists[level] = node->forward[0];
+        } else {
+            size_t bytes = Node::bytesFor(level);
+            // Keep small nodes from straddling two cache lines
+            size_t offset = reinterpret_cast<size_t>(cursor) % CACHE_LINE;
+            if (bytes <= CACHE_LINE && offset + bytes > CACHE_LINE && remaining >= CACHE_LINE - offset) {
+                cursor += CACHE_LINE - offset;
+                remaining -= CACHE_LINE - offset;
+            }
+            if (bytes > remaining) {
+                size_t blockBytes = bytes > BLOCK_BYTES ? bytes : BLOCK_BYTES;
+                cursor = static_cast<char*>(operator new(blockBytes, align_val_t(CACHE_LINE)));
+                remaining = blockBytes;
+                blocks.push_back(cursor);
+            }
+            node = reinterpret_cast<Node*>(cursor);
+            cursor += bytes;
+            remaining -= bytes;
+        }
+
+        node->value = value;
+        node->level = level;
+        for (int i = 0; i <= level; i++) {
+            node->forward[i] = nullptr;
+            node->span()[i] = 0;
+        }
+        return node;
+    }
 
-    Node(int val, int level) : value(val), forward(level + 1, nullptr) {}
+    void release(Node* node) {
+        node->forward[0] = freeLists[node->level];
+        freeLists[node->level] = node;
+    }
 };
 
 // Skip List class
 class SkipList {
-    int maxLevel;     // Maximum level of the skip list
+    int maxLevel;     // Maximum level of the skip list, grows with the element count
     float probability; // Probability for increasing levels
+    NodeArena arena;  // Owns every node, including the header
     Node* header;     // Header node
     int level;        // Current highest level in the list
+    long long count;  // Number of values stored
+    double nextGrowth; // Element count at which maxLevel is raised again: (1/p)^maxLevel
+    uint64_t rngState; // Per-instance xorshift64* state
+    int bitsPerLevel; // k when probability == 1/2^k (levels come from trailing zeros), else 0
 
-public:
-    SkipList(int maxLvl, float prob) : maxLevel(maxLvl), probability(prob), level(0) {
-        header = new Node(-1, maxLevel); // Initialize header node
+    uint64_t nextRandom() {
+        rngState ^= rngState >> 12;
+        rngState ^= rngState << 25;
+        rngState ^= rngState >> 27;
+        return rngState * 0x2545F4914F6CDD1DULL;
     }
 
-    ~SkipList() {
-        delete header;
+public:
+    // A seed of 0 draws one from rand(), so srand() still controls the layout;
+    // pass a fixed seed for reproducible benchmarks.
+    SkipList(int maxLvl, float prob, uint64_t seed = 0)
+        : maxLevel(maxLvl), probability(prob), level(0), count(0), bitsPerLevel(0) {
+        if (maxLevel > MAX_LEVEL_CAP)
+            maxLevel = MAX_LEVEL_CAP;
+        if (maxLevel < 0)
+            maxLevel = 0;
+        nextGrowth = pow(1.0 / probability, maxLevel);
+        header = arena.allocate(-1, MAX_LEVEL_CAP); // Header is tall enough for any future maxLevel
+
+        if (seed == 0)
+            seed = (uint64_t(rand()) << 32) ^ uint64_t(rand()) ^ 0x9E3779B97F4A7C15ULL;
+        rngState = seed;
+
+        for (int k = 1; k <= 8; k++) {
+            if (fabs(probability - ldexp(1.0, -k)) < 1e-7) {
+                bitsPerLevel = k;
+                break;
+            }
+        }
     }
 
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
+
+    long long size() const { return count; }
+
     // Generate a random level for a new node
     int randomLevel() {
         int lvl = 0;
-        while ((rand() / double(RAND_MAX)) < probability && lvl < maxLevel) {
+        if (bitsPerLevel > 0) {
+            // Each run of bitsPerLevel zero bits is one success with probability 1/2^k
+            uint64_t bits = nextRandom() | (1ULL << 63);
+            lvl = __builtin_ctzll(bits) / bitsPerLevel;
+            return lvl < maxLevel ? lvl : maxLevel;
+        }
+        while ((nextRandom() >> 11) * 0x1.0p-53 < probability && lvl < maxLevel) {
             lvl++;
         }
         return lvl;
     }
 
-    // Insert a value into the skip list
-    void insert(int value) {
-        vector<Node*> update(maxLevel + 1, nullptr);
-        Node* current = header;
+    // Remembers the predecessors (and their positions) of the last value
+    // touched through it, so the next nearby operation only climbs and
+    // descends O(log d) levels, d being the distance between the two values.
+    // Any change made without this finger invalidates it, and so does using it
+    // on another list; it then falls back to a search from the header.
+    struct Finger {
+        Node* update[MAX_LEVEL_CAP + 1];
+        long long rank[MAX_LEVEL_CAP + 1]; // Position of update[i]; the header is position 0
+        const SkipList* owner = nullptr;    // List the entries point into
+        unsigned long long version = 0;     // That list's version when they were taken
+    };
 
-        // Find the position to insert
-        for (int i = level; i >= 0; i--) {
+private:
+    unsigned long long version = 1; // Bumped on every insert/remove, see Finger
+
+    // update[i] still precedes value on level i and its link does not skip past value
+    bool brackets(Node* node, int i, int value) {
+        return (node == header || node->value < value) &&
+               (!node->forward[i] || node->forward[i]->value >= value);
+    }
+
+    // Fill finger.update/rank with the predecessors of value on every level,
+    // reusing the entries that still bracket value when the finger is current
+    void locate(Finger& finger, int value, bool reuse = true) {
+        int top = level + 1; // First level the finger cannot be reused on
+        if (reuse && finger.owner == this && finger.version == version) {
+            top = 0;
+            while (top <= level && !brackets(finger.update[top], top, value))
+                top++;
+        }
+
+        Node* current = header;
+        long long position = 0;
+        if (top <= level) {
+            current = finger.update[top];
+            position = finger.rank[top];
+        } else {
+            top = level + 1;
+        }
+        for (int i = top - 1; i >= 0; i--) {
             while (current->forward[i] && current->forward[i]->value < value) {
+                position += current->span()[i];
                 current = current->forward[i];
             }
-            update[i] = current;
+            finger.update[i] = current;
+            finger.rank[i] = position;
         }
+        finger.owner = this;
+        finger.version = version;
+    }
 
-        current = current->forward[0];
+public:
+    // Insert a value into the skip list
+    void insert(int value) {
+        Finger finger;
+        insertVia(finger, value, false);
+    }
+
+    // Insert starting from a finger left by a previous operation
+    void insert(Finger& finger, int value) {
+        insertVia(finger, value, true);
+    }
+
+private:
+    void insertVia(Finger& finger, int value, bool reuse) {
+        locate(finger, value, reuse);
+        Node** update = finger.update;
+        long long* rank = finger.rank;
+        Node* current = update[0]->forward[0];
 
         // If the value doesn't already exist, insert it
         if (!current || current->value != value) {
@@ -58,18 +233,55 @@ public:
             if (randomLvl > level) {
                 for (int i = level + 1; i <= randomLvl; i++) {
                     update[i] = header;
+                    rank[i] = 0;
+                    header->span()[i] = count;
                 }
                 level = randomLvl;
             }
 
-            Node* newNode = new Node(value, randomLvl);
+            Node* newNode = arena.allocate(value, randomLvl);
             for (int i = 0; i <= randomLvl; i++) {
                 newNode->forward[i] = update[i]->forward[i];
                 update[i]->forward[i] = newNode;
+
+                // The new node sits rank[0] - rank[i] + 1 steps after update[i]
+                newNode->span()[i] = update[i]->span()[i] - (rank[0] - rank[i]);
+                update[i]->span()[i] = rank[0] - rank[i] + 1;
+            }
+            // Links passing over the new node now cover one more step
+            for (int i = randomLvl + 1; i <= level; i++) {
+                update[i]->span()[i]++;
+            }
+
+            // Leave the finger on the new node, ready for an ascending successor
+            long long newRank = rank[0] + 1;
+            for (int i = 0; i <= randomLvl; i++) {
+                update[i] = newNode;
+                rank[i] = newRank;
+            }
+            finger.version = ++version;
+
+            // Keep maxLevel near log_{1/p}(count) so searches stay logarithmic
+            count++;
+            if (count >= nextGrowth && maxLevel < MAX_LEVEL_CAP) {
+                maxLevel++;
+                nextGrowth /= probability;
             }
         }
     }
 
+public:
+    // Insert an ascending run of values in one merged pass: each value is
+    // placed from the finger left by its predecessor, so a sorted batch costs
+    // close to O(1) per value instead of a search from the header.
+    // Unsorted input is still inserted correctly, only slower.
+    template <typename Iterator>
+    void bulkInsert(Iterator first, Iterator last) {
+        Finger finger;
+        for (; first != last; ++first)
+            insert(finger, *first);
+    }
+
     // Search for a value in the skip list
     bool search(int value) {
         Node* current = header;
@@ -84,29 +296,44 @@ public:
         return current && current->value == value;
     }
 
+    // Search starting from a finger left by a previous operation
+    bool search(Finger& finger, int value) {
+        locate(finger, value);
+        Node* current = finger.update[0]->forward[0];
+        return current && current->value == value;
+    }
+
     // Delete a value from the skip list
     void remove(int value) {
-        vector<Node*> update(maxLevel + 1, nullptr);
-        Node* current = header;
+        Finger finger;
+        removeVia(finger, value, false);
+    }
 
-        // Find the position to remove
-        for (int i = level; i >= 0; i--) {
-            while (current->forward[i] && current->forward[i]->value < value) {
-                current = current->forward[i];
-            }
-            update[i] = current;
-        }
+    // Delete starting from a finger left by a previous operation
+    void remove(Finger& finger, int value) {
+        removeVia(finger, value, true);
+    }
 
-        current = current->forward[0];
+private:
+    void removeVia(Finger& finger, int value, bool reuse) {
+        locate(finger, value, reuse);
+        Node** update = finger.update;
+        Node* current = update[0]->forward[0];
 
         // If the value exists, remove it
         if (current && current->value == value) {
             for (int i = 0; i <= level; i++) {
-                if (update[i]->forward[i] != current) break;
-                update[i]->forward[i] = current->forward[i];
+                if (update[i]->forward[i] == current) {
+                    update[i]->span()[i] += current->span()[i] - 1;
+                    update[i]->forward[i] = current->forward[i];
+                } else {
+                    update[i]->span()[i]--;
+                }
             }
 
-            delete current;
+            arena.release(current);
+            count--;
+            finger.version = ++version;
 
             // Update the level of the skip list if the level is empty !header->forward[level]
             while (level > 0 && !header->forward[level]) {
@@ -115,6 +342,162 @@ public:
         }
     }
 
+public:
+    // Remove every value in [lo, hi] with one pass over the levels: the run is
+    // cut out of each level by relinking its predecessor once, then its nodes
+    // are released. O(log n + k) for k removed values. Returns k.
+    long long removeRange(int lo, int hi) {
+        if (lo > hi)
+            return 0;
+
+        Finger finger;
+        locate(finger, lo, false);
+        Node** update = finger.update;
+
+        // Level 0 first, to learn how many values go
+        Node* first = update[0]->forward[0];
+        Node* stop = first;
+        long long removed = 0;
+        while (stop && stop->value <= hi) {
+            stop = stop->forward[0];
+            removed++;
+        }
+        if (removed == 0)
+            return 0;
+
+        for (int i = 0; i <= level; i++) {
+            long long span = update[i]->span()[i];
+            Node* next = update[i]->forward[i];
+            while (next && next->value <= hi) {
+                span += next->span()[i];
+                next = next->forward[i];
+            }
+            update[i]->forward[i] = next;
+            update[i]->span()[i] = span - removed;
+        }
+
+        while (first != stop) {
+            Node* next = first->forward[0];
+            arena.release(first);
+            first = next;
+        }
+        count -= removed;
+        version++;
+
+        while (level > 0 && !header->forward[level]) {
+            level--;
+        }
+        return removed;
+    }
+
+    // Forward iterator over the values in ascending order. Removing the value
+    // an iterator points at invalidates that iterator.
+    class const_iterator {
+        Node* node;
+
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef const int& reference;
+
+        explicit const_iterator(Node* node = nullptr) : node(node) {}
+
+        reference operator*() const { return node->value; }
+        pointer operator->() const { return &node->value; }
+
+        const_iterator& operator++() {
+            node = node->forward[0];
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            node = node->forward[0];
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const { return node == other.node; }
+        bool operator!=(const const_iterator& other) const { return node != other.node; }
+    };
+
+    const_iterator begin() const { return const_iterator(header->forward[0]); }
+    const_iterator end() const { return const_iterator(); }
+
+    // First value that is not less than value, in O(log n)
+    const_iterator lowerBound(int value) const {
+        Node* current = header;
+        for (int i = level; i >= 0; i--) {
+            while (current->forward[i] && current->forward[i]->value < value) {
+                current = current->forward[i];
+            }
+        }
+        return const_iterator(current->forward[0]);
+    }
+
+    // Call visit(value) for every value in [lo, hi], in ascending order
+    template <typename Visitor>
+    void forEachInRange(int lo, int hi, Visitor visit) const {
+        for (const_iterator it = lowerBound(lo); it != end() && *it <= hi; ++it)
+            visit(*it);
+    }
+
+    // Number of values below value (or at most value when inclusive), in O(log n)
+    long long countBelow(int value, bool inclusive) {
+        long long traversed = 0;
+        Node* current = header;
+        for (int i = level; i >= 0; i--) {
+            while (current->forward[i] &&
+                   (current->forward[i]->value < value || (inclusive && current->forward[i]->value == value))) {
+                traversed += current->span()[i];
+                current = current->forward[i];
+            }
+        }
+        return traversed;
+    }
+
+    // Value at 0-based position index in sorted order; false if out of range
+    bool at(long long index, int& value) {
+        if (index < 0 || index >= count)
+            return false;
+
+        long long traversed = 0;
+        Node* current = header;
+        for (int i = level; i >= 0; i--) {
+            while (current->forward[i] && traversed + current->span()[i] <= index + 1) {
+                traversed += current->span()[i];
+                current = current->forward[i];
+            }
+            if (traversed == index + 1) {
+                value = current->value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 0-based position of value in sorted order, or -1 if it is not present
+    long long rank(int value) {
+        long long traversed = 0;
+        Node* current = header;
+        for (int i = level; i >= 0; i--) {
+            while (current->forward[i] && current->forward[i]->value < value) {
+                traversed += current->span()[i];
+                current = current->forward[i];
+            }
+        }
+        current = current->forward[0];
+        return (current && current->value == value) ? traversed : -1;
+    }
+
+    // Number of values in [lo, hi]
+    long long countBetween(int lo, int hi) {
+        if (lo > hi)
+            return 0;
+        return countBelow(hi, true) - countBelow(lo, false);
+    }
+
     // Display the skip list
     void display() {
         for (int i = 0; i <= level; i++) {
@@ -129,6 +512,8 @@ public:
     }
 };
 
+// Define SKIPLIST_NO_MAIN to include this file from another program (e.g. a benchmark)
+#ifndef SKIPLIST_NO_MAIN
 // Example usage
 int main() {
     srand(time(0)); // Seed for randomness
@@ -152,5 +537,25 @@ int main() {
     cout << "Skip List after deletion of 7:" << endl;
     skipList.display();
 
+    int median;
+    if (skipList.at(skipList.size() / 2, median))
+        cout << "Median: " << median << endl;
+    cout << "Rank of 12: " << skipList.rank(12) << endl;
+    cout << "Values in [5, 20]: " << skipList.countBetween(5, 20) << endl;
+
+    // Mostly ordered batch, e.g. timestamped events
+    vector<int> batch = {60, 61, 63, 62, 70, 71, 75};
+    skipList.bulkInsert(batch.begin(), batch.end());
+    cout << "Skip List after bulk insertion:" << endl;
+    skipList.display();
+
+    cout << "Values in [10, 65]: ";
+    skipList.forEachInRange(10, 65, [](int value) { cout << value << " "; });
+    cout << endl;
+
+    cout << "Removed " << skipList.removeRange(55, 72) << " values in [55, 72]:" << endl;
+    skipList.display();
+
     return 0;
 }
+#endif // SKIPLIST_NO_MAIN
@@ -0,0 +1,496 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+using namespace std;
+
+#define PLAYERS_NO_MAIN
+#include "PlayersProbUsingSkipList.cpp"
+#include "BenchmarkUtil.h"
+
+// Daily, weekly, rolling-window and decaying leaderboards kept side by side,
+// each one a SkipList from PlayersProbUsingSkipList.cpp. Scores are points
+// earned inside the window. Time is in seconds and must not go backwards.
+// Expiring a window does not cost one removePlayer call per player:
+//   - tumbling boards swap in an empty board and clear the old one
+//   - the rolling board drops whole time buckets; when many players are left
+//     without points they are removed in a single removeIf sweep
+//   - the decaying board never rewrites scores as time passes (see DecayingBoard)
+
+const long long SECONDS_PER_HOUR = 3600;
+const long long SECONDS_PER_DAY = 24 * SECONDS_PER_HOUR;
+const long long SECONDS_PER_WEEK = 7 * SECONDS_PER_DAY;
+const long long FIRST_MONDAY = 4 * SECONDS_PER_DAY; // 1970-01-05 00:00 UTC; the epoch itself is a Thursday
+const int BOARD_MAX_LEVEL = 20;
+
+long long floorDiv(long long a, long long b)
+{
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+// Add points to a player, joining the board if needed
+void addPoints(SkipList &board, int playerId, long long points)
+{
+    int score;
+    if (board.getScore(playerId, score))
+    {
+        board.updateScore(playerId, clampScore(score + points));
+    }
+    else
+    {
+        board.addPlayer(playerId, clampScore(points));
+    }
+}
+
+// Restarts every windowSeconds. Windows start at origin plus a whole number of
+// windows, so origin picks the boundary: FIRST_MONDAY for weeks starting on
+// Monday 00:00 UTC, or a time zone's UTC offset for local midnight.
+// The board of the window that just ended stays readable until the next one ends.
+class TumblingBoard
+{
+    long long windowSeconds;
+    long long origin;
+    long long windowIndex = LLONG_MIN;
+    unique_ptr<SkipList> current, previous;
+
+public:
+    TumblingBoard(long long windowSeconds, long long origin = 0)
+        : windowSeconds(windowSeconds), origin(origin), current(new SkipList(BOARD_MAX_LEVEL, 0.5, false)),
+          previous(new SkipList(BOARD_MAX_LEVEL, 0.5, false))
+    {
+    }
+
+    void advanceTo(long long now)
+    {
+        long long index = floorDiv(now - origin, windowSeconds);
+        if (index == windowIndex)
+        {
+            return;
+        }
+        previous->clear();
+        if (index == windowIndex + 1)
+        {
+            swap(current, previous);
+        }
+        else
+        {
+            current->clear(); // Skipped a whole window, so nothing to keep
+        }
+        windowIndex = index;
+    }
+
+    void addPoints(int playerId, int points, long long now)
+    {
+        advanceTo(now);
+        ::addPoints(*current, playerId, points);
+    }
+
+    SkipList &board() { return *current; }
+    SkipList &previousBoard() { return *previous; }
+    long long windowStart() const { return origin + windowIndex * windowSeconds; }
+};
+
+// Points earned in the last windowSeconds, tracked in bucketSeconds slices.
+// The window slides one bucket at a time: the oldest bucket's points are
+// subtracted, and players with no points left in any bucket are removed.
+class RollingBoard
+{
+    struct Bucket
+    {
+        long long index;
+        unordered_map<int, int> points; // Per player, earned inside this bucket
+    };
+
+    long long windowSeconds, bucketSeconds;
+    SkipList board;
+    deque<Bucket> buckets;
+    unordered_map<int, int> liveBuckets; // Buckets in the window holding points for each player
+
+public:
+    long long bulkSweeps = 0;        // Expiries done with one removeIf pass
+    long long individualRemoves = 0; // Expiries done with removePlayer
+
+    RollingBoard(long long windowSeconds, long long bucketSeconds)
+        : windowSeconds(windowSeconds), bucketSeconds(bucketSeconds), board(BOARD_MAX_LEVEL, 0.5, false)
+    {
+    }
+
+    void advanceTo(long long now)
+    {
+        long long oldestLive = floorDiv(now, bucketSeconds) - windowSeconds / bucketSeconds + 1;
+        unordered_set<int> expired;
+        while (!buckets.empty() && buckets.front().index < oldestLive)
+        {
+            for (const auto &entry : buckets.front().points)
+            {
+                auto live = liveBuckets.find(entry.first);
+                if (--live->second == 0)
+                {
+                    liveBuckets.erase(live);
+                    expired.insert(entry.first);
+                }
+                else
+                {
+                    ::addPoints(board, entry.first, -(long long)entry.second);
+                }
+            }
+            buckets.pop_front();
+        }
+        if (expired.empty())
+        {
+            return;
+        }
+
+        // A sweep touches every player once; a removal costs about log2(n) steps
+        int size = board.size();
+        if ((double)expired.size() * log2(size + 1.0) >= size)
+        {
+            board.removeIf([&expired](int playerId, int) { return expired.count(playerId) != 0; });
+            bulkSweeps++;
+        }
+        else
+        {
+            for (int playerId : expired)
+            {
+                board.removePlayer(playerId);
+            }
+            individualRemoves += expired.size();
+        }
+    }
+
+    void addPoints(int playerId, int points, long long now)
+    {
+        advanceTo(now);
+        long long index = floorDiv(now, bucketSeconds);
+        if (buckets.empty() || buckets.back().index != index)
+        {
+            buckets.push_back({index, {}});
+        }
+        auto inserted = buckets.back().points.emplace(playerId, 0);
+        if (inserted.second)
+        {
+            liveBuckets[playerId]++;
+        }
+        inserted.first->second += points;
+        ::addPoints(board, playerId, points);
+    }
+
+    SkipList &view() { return board; }
+};
+
+// Scores that halve every halfLifeSeconds. Decaying every score as time passes
+// would rewrite every node, but all scores shrink by the same factor, so their
+// order never changes. Points are instead stored inflated by
+// exp(lambda * (t - epochStart)), where t is when they were earned. A stored
+// score divided by exp(lambda * (now - epochStart)) is the decayed score. Once
+// that factor passes REBASE_GROWTH, the board is rescaled to a new epoch in a
+// single rebuild, and entries that have decayed to nothing are dropped.
+// Stored scores are 64-bit: with SCORE_UNITS and REBASE_GROWTH they are up to
+// 1600 times the real score, which would saturate an int at 1.34M points.
+class DecayingBoard
+{
+public:
+    typedef BasicSkipList<BasicPlayerIndex<BasicNode<long long>>> ScaledSkipList;
+
+private:
+    static constexpr double SCORE_UNITS = 100;  // Stored resolution: 0.01 point
+    static constexpr double REBASE_GROWTH = 16; // Rebuild at least every 4 half-lives
+
+    double lambda;
+    long long epochStart = LLONG_MIN;
+    ScaledSkipList board;
+
+    double growth(long long now) const
+    {
+        if (epochStart == LLONG_MIN)
+        {
+            return 1.0; // Nothing recorded yet
+        }
+        return exp(lambda * double(now - epochStart));
+    }
+
+    void rebase(long long now)
+    {
+        struct Entry
+        {
+            int playerId;
+            long long score;
+        };
+        double factor = 1.0 / growth(now);
+        vector<Entry> entries;
+        entries.reserve(board.size());
+        board.forEachPlayer([&](int playerId, long long score)
+                            {
+            long long scaled = llround(score * factor);
+            if (scaled != 0)
+            {
+                entries.push_back({playerId, scaled});
+            } });
+
+        // Rounding can turn a strict order into a tie, which breaks by playerId
+        sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+             { return a.score > b.score || (a.score == b.score && a.playerId < b.playerId); });
+        board.clear();
+        board.loadSorted(entries.begin(), entries.end());
+        epochStart = now;
+        rebases++;
+    }
+
+public:
+    long long rebases = 0;
+
+    DecayingBoard(double halfLifeSeconds)
+        : lambda(log(2.0) / halfLifeSeconds), board(BOARD_MAX_LEVEL, 0.5, false)
+    {
+    }
+
+    void advanceTo(long long now)
+    {
+        if (epochStart == LLONG_MIN)
+        {
+            epochStart = now;
+        }
+        else if (growth(now) > REBASE_GROWTH)
+        {
+            rebase(now);
+        }
+    }
+
+    void addPoints(int playerId, int points, long long now)
+    {
+        advanceTo(now);
+        long long scaled = llround(points * SCORE_UNITS * growth(now));
+        long long stored;
+        if (board.getScore(playerId, stored))
+        {
+            board.updateScore(playerId, stored + scaled);
+        }
+        else
+        {
+            board.addPlayer(playerId, scaled);
+        }
+    }
+
+    double decayedScore(int playerId, long long now)
+    {
+        long long stored;
+        return board.getScore(playerId, stored) ? stored / SCORE_UNITS / growth(now) : 0.0;
+    }
+
+    void displayLeaderboard(int topN, long long now)
+    {
+        cout << "Top " << topN << " players (decayed):" << endl;
+        double scale = 1.0 / (SCORE_UNITS * growth(now));
+        for (const ScaledSkipList::Entry &entry : board.getPage(0, topN))
+        {
+            cout << "ID: " << entry.playerId << " (Score: " << fixed << setprecision(2) << entry.score * scale << ")"
+                 << endl;
+        }
+        cout.unsetf(ios::fixed);
+    }
+
+    ScaledSkipList &view() { return board; }
+};
+
+// All the boards above fed from one stream of (player, points, time) events
+class WindowedLeaderboard
+{
+    TumblingBoard daily, weekly;
+    RollingBoard rolling;
+    unique_ptr<DecayingBoard> decaying;
+
+public:
+    // halfLifeSeconds <= 0 turns the decaying board off. Days start at
+    // dayOrigin (midnight UTC by default) and weeks at weekOrigin (Monday).
+    WindowedLeaderboard(long long rollingWindowSeconds = SECONDS_PER_DAY, long long rollingBucketSeconds = SECONDS_PER_HOUR,
+                        double halfLifeSeconds = 0, long long dayOrigin = 0, long long weekOrigin = FIRST_MONDAY)
+        : daily(SECONDS_PER_DAY, dayOrigin), weekly(SECONDS_PER_WEEK, weekOrigin),
+          rolling(rollingWindowSeconds, rollingBucketSeconds)
+    {
+        if (halfLifeSeconds > 0)
+        {
+            decaying.reset(new DecayingBoard(halfLifeSeconds));
+        }
+    }
+
+    void recordPoints(int playerId, int points, long long now)
+    {
+        daily.addPoints(playerId, points, now);
+        weekly.addPoints(playerId, points, now);
+        rolling.addPoints(playerId, points, now);
+        if (decaying)
+        {
+            decaying->addPoints(playerId, points, now);
+        }
+    }
+
+    // Let windows expire without new events, e.g. before reading at a quiet time
+    void advanceTo(long long now)
+    {
+        daily.advanceTo(now);
+        weekly.advanceTo(now);
+        rolling.advanceTo(now);
+        if (decaying)
+        {
+            decaying->advanceTo(now);
+        }
+    }
+
+    TumblingBoard &weeklyWindow() { return weekly; }
+    SkipList &dailyBoard() { return daily.board(); }
+    SkipList &yesterdayBoard() { return daily.previousBoard(); }
+    SkipList &weeklyBoard() { return weekly.board(); }
+    SkipList &lastWeekBoard() { return weekly.previousBoard(); }
+    SkipList &rollingBoard() { return rolling.view(); }
+    RollingBoard &rollingWindow() { return rolling; }
+    DecayingBoard *decayingBoard() { return decaying.get(); }
+};
+
+double millisecondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Expire half of a board with one removeIf sweep versus one removePlayer per player
+void compareExpiry(int players)
+{
+    uint64_t rng = 7;
+    SkipList sweep(BOARD_MAX_LEVEL, 0.5, false), individual(BOARD_MAX_LEVEL, 0.5, false);
+    for (int id = 0; id < players; id++)
+    {
+        int score = int(nextRandom(rng) % 100000);
+        sweep.addPlayer(id, score);
+        individual.addPlayer(id, score);
+    }
+
+    auto start = chrono::steady_clock::now();
+    sweep.removeIf([](int playerId, int) { return playerId % 2 == 0; });
+    double sweepMs = millisecondsSince(start);
+
+    start = chrono::steady_clock::now();
+    for (int id = 0; id < players; id += 2)
+    {
+        individual.removePlayer(id);
+    }
+    double individualMs = millisecondsSince(start);
+
+    cout << "Expire " << players / 2 << " of " << players << " players: removeIf " << fixed << setprecision(1)
+         << sweepMs << " ms, removePlayer loop " << individualMs << " ms" << endl;
+    cout.unsetf(ios::fixed);
+}
+
+// Points earned on Sunday night and Monday morning fall in different weeks,
+// while Thursday (the weekday of the Unix epoch) is not a boundary
+bool weekBoundaryTest()
+{
+    const long long monday = 1760918400; // 2025-10-20 00:00 UTC
+    WindowedLeaderboard leaderboard;
+    int score;
+
+    leaderboard.recordPoints(1, 10, monday - 1); // Sunday 23:59:59
+    if (leaderboard.weeklyWindow().windowStart() != monday - SECONDS_PER_WEEK)
+    {
+        return false;
+    }
+    leaderboard.recordPoints(2, 20, monday);
+    if (leaderboard.weeklyWindow().windowStart() != monday || leaderboard.weeklyBoard().size() != 1 ||
+        !leaderboard.weeklyBoard().getScore(2, score) || !leaderboard.lastWeekBoard().getScore(1, score))
+    {
+        return false;
+    }
+
+    long long thursday = monday + 3 * SECONDS_PER_DAY;
+    leaderboard.recordPoints(3, 30, thursday - 1);
+    leaderboard.recordPoints(4, 40, thursday);
+    if (leaderboard.weeklyWindow().windowStart() != monday || leaderboard.weeklyBoard().size() != 3)
+    {
+        return false;
+    }
+
+    // A week starting on Sunday is a matter of passing that origin
+    TumblingBoard sundayWeeks(SECONDS_PER_WEEK, FIRST_MONDAY - SECONDS_PER_DAY);
+    sundayWeeks.advanceTo(monday - 1);
+    return sundayWeeks.windowStart() == monday - SECONDS_PER_DAY;
+}
+
+// Just before a rebase a point is stored as about 1600 units; a few million
+// points must still come back exactly rather than saturate
+bool largeDecayedScoreTest()
+{
+    DecayingBoard board(SECONDS_PER_HOUR);
+    long long start = 0, now = 4 * SECONDS_PER_HOUR - 60; // Growth just under 16
+    board.addPoints(1, 1, start);
+    board.addPoints(2, 2000000, now);
+    board.addPoints(2, 2000000, now);
+    board.addPoints(3, 3000000, now);
+    return fabs(board.decayedScore(2, now) - 4000000) < 0.01 && fabs(board.decayedScore(3, now) - 3000000) < 0.01 &&
+           board.view().getRank(2) == 1;
+}
+
+int main()
+{
+    srand(time(0));
+
+    cout << "Week boundary test: " << (weekBoundaryTest() ? "passed" : "FAILED") << endl;
+    cout << "Large decayed score test: " << (largeDecayedScoreTest() ? "passed" : "FAILED") << endl << endl;
+
+    // Rolling 24h window in hourly buckets; decayed scores halve every 12h
+    WindowedLeaderboard leaderboard(SECONDS_PER_DAY, SECONDS_PER_HOUR, 12 * SECONDS_PER_HOUR);
+    long long monday = 1760918400; // 2025-10-20 00:00 UTC
+
+    leaderboard.recordPoints(1, 50, monday + 9 * SECONDS_PER_HOUR);
+    leaderboard.recordPoints(2, 70, monday + 10 * SECONDS_PER_HOUR);
+    leaderboard.recordPoints(3, 30, monday + 20 * SECONDS_PER_HOUR);
+    leaderboard.recordPoints(1, 40, monday + SECONDS_PER_DAY + 8 * SECONDS_PER_HOUR); // Tuesday
+
+    cout << "Tuesday 08:00, daily board:" << endl;
+    leaderboard.dailyBoard().displayLeaderboard(3);
+    cout << "Yesterday's board:" << endl;
+    leaderboard.yesterdayBoard().displayLeaderboard(3);
+    cout << "Weekly board:" << endl;
+    leaderboard.weeklyBoard().displayLeaderboard(3);
+    cout << "Rolling 24h board:" << endl;
+    leaderboard.rollingBoard().displayLeaderboard(3);
+    leaderboard.decayingBoard()->displayLeaderboard(3, monday + SECONDS_PER_DAY + 8 * SECONDS_PER_HOUR);
+
+    // Monday's morning points slide out of the rolling window
+    long long tuesdayNoon = monday + SECONDS_PER_DAY + 12 * SECONDS_PER_HOUR;
+    leaderboard.advanceTo(tuesdayNoon);
+    cout << "\nTuesday 12:00, rolling 24h board:" << endl;
+    leaderboard.rollingBoard().displayLeaderboard(3);
+    leaderboard.decayingBoard()->displayLeaderboard(3, tuesdayNoon);
+
+    // A month of traffic: 1M events from 100k players with a hot minority
+    const int players = 100000;
+    const int events = 1000000;
+    WindowedLeaderboard load(SECONDS_PER_DAY, SECONDS_PER_HOUR, 6 * SECONDS_PER_HOUR);
+    uint64_t rng = 12345;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < events; i++)
+    {
+        long long now = (long long)i * 30 * SECONDS_PER_DAY / events;
+        uint64_t r = nextRandom(rng);
+        int playerId = (r & 3) ? int((r >> 2) % (players / 20)) : int((r >> 2) % players);
+        load.recordPoints(playerId, 1 + int((r >> 40) % 100), now);
+    }
+    double elapsedMs = millisecondsSince(start);
+    cout << "\n" << events << " events over 30 days: " << fixed << setprecision(2)
+         << events / elapsedMs / 1e3 << " M events/s" << endl;
+    cout.unsetf(ios::fixed);
+    cout << "Board sizes: daily " << load.dailyBoard().size() << ", weekly " << load.weeklyBoard().size()
+         << ", rolling " << load.rollingBoard().size() << ", decaying " << load.decayingBoard()->view().size() << endl;
+    cout << "Rolling expiries: " << load.rollingWindow().bulkSweeps << " bulk sweeps, "
+         << load.rollingWindow().individualRemoves << " individual removes; decay rebases: "
+         << load.decayingBoard()->rebases << endl;
+
+    compareExpiry(200000);
+
+    return 0;
+}